@@ -1,18 +1,84 @@
 #include "AI.h"
 #include "PathFinding.h"
+#include "ThreatSearch.h"
 #include <chrono>
 #include <algorithm>
+#include <cstdlib>
+#include <thread>
 
-AI::AI() {}
+const int AI::MAX_DEFAULT_THREADS;
+
+AI::AI() : moveTimeMs(DEFAULT_MOVE_TIME_MS), monteCarloMode(MonteCarloMode::FLAT),
+           solverMaxEmptyCells(SOLVER_MAX_EMPTY_CELLS), solverNodeBudget(SOLVER_NODE_BUDGET),
+           scorer(std::make_shared<MoveScorer>()), solver(SOLVER_HASH_MB), ponderStop(false) {
+    minimax.setMoveScorer(scorer);
+    monteCarlo.setMoveScorer(scorer);
+    int hardwareThreads = (int)std::thread::hardware_concurrency();
+    setSearchThreads(std::max(1, std::min(MAX_DEFAULT_THREADS, hardwareThreads)));
+}
+
+AI::~AI() {
+    stopPondering();
+}
+
+void AI::newGame() {
+    stopPondering();
+    minimax.clearHash();
+    scorer->clear();
+    solver.clear();
+}
+
+void AI::startPondering(const HexGrid& grid) {
+    stopPondering();
+    if (grid.getWinner() != Player::NONE || grid.getEmptyCount() < 2) return;
+    
+    ponderGrid = grid;
+    ponderStop = false;
+    ponderThread = std::thread([this]() {
+        // A short search from the opponent's side picks the reply to expect
+        // (and fills the table for the others), then the position after it
+        // is searched with no time limit until stopPondering
+        SearchLimits predict{MAX_SEARCH_DEPTH, std::max(1, moveTimeMs / 4), 0, &ponderStop};
+        MinimaxResult expected = minimax.findBestMove(ponderGrid, predict);
+        if (ponderStop || !ponderGrid.makeMove(expected.move.coord)) return;
+        ponderSearchStart = std::chrono::steady_clock::now();
+        if (ponderGrid.getWinner() != Player::NONE) return;
+        SearchLimits limits{MAX_SEARCH_DEPTH, 0, 0, &ponderStop};
+        minimax.findBestMove(ponderGrid, limits);
+    });
+}
+
+void AI::stopPondering() {
+    if (!ponderThread.joinable()) return;
+    ponderStop = true;
+    ponderThread.join();
+}
 
 MoveInfo AI::calculateMove(HexGrid& grid) {
     auto startTime = std::chrono::high_resolution_clock::now();
     
+    // Pondering shares the Minimax engine, so it stops before anything else.
+    // The pondered board is only safe to read once its search has returned.
+    bool ponderHit = false;
+    int ponderTime = 0;
+    if (ponderThread.joinable()) {
+        auto ponderEnd = std::chrono::steady_clock::now();
+        stopPondering();
+        // Only the search of the position that arose counts, not the
+        // prediction before it
+        ponderHit = ponderGrid.getHash() == grid.getHash();
+        if (ponderHit) {
+            ponderTime = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                ponderEnd - ponderSearchStart).count();
+        }
+    }
+    
     Player aiPlayer = grid.getCurrentPlayer();
     Player opponent = (aiPlayer == Player::RED) ? Player::BLUE : Player::RED;
     
     bool isWinningMove = false;
     bool isBlockingMove = false;
+    bool isProvenWin = false;
     Move finalMove;
     
     // PRIORITY 1: Check if AI can win immediately
@@ -20,6 +86,7 @@ MoveInfo AI::calculateMove(HexGrid& grid) {
     if (winMove.q != -1) {
         finalMove = Move(winMove, aiPlayer);
         isWinningMove = true;
+        isProvenWin = true;
         
         auto endTime = std::chrono::high_resolution_clock::now();
         int thinkTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
@@ -32,7 +99,17 @@ MoveInfo AI::calculateMove(HexGrid& grid) {
             1.0,
             thinkTime,
             isWinningMove,
-            isBlockingMove
+            isBlockingMove,
+            isProvenWin,
+            0,
+            0,
+            0.0,
+            0.0,
+            0,
+            0,
+            0,
+            ponderHit,
+            ponderTime
         };
     }
     
@@ -53,32 +130,140 @@ MoveInfo AI::calculateMove(HexGrid& grid) {
             0.9,
             thinkTime,
             isWinningMove,
-            isBlockingMove
+            isBlockingMove,
+            isProvenWin,
+            0,
+            0,
+            0.0,
+            0.0,
+            0,
+            0,
+            0,
+            ponderHit,
+            ponderTime
         };
     }
     
-    // PRIORITY 3: Use adaptive depth search with Minimax (primary) + Monte Carlo (validation)
-    // Adaptive depth based on board state (less moves = deeper search possible)
-    int moveCount = 0;
-    for (const auto& kv : grid.getGrid()) {
-        if (kv.second != Player::NONE) moveCount++;
+    // PRIORITY 3: A forced win through a sequence of threats
+    // The solve, and the defence check further down, each get an eighth of
+    // the move time in nodes
+    int threatNodes = moveTimeMs / 8 * THREAT_NODES_PER_MS;
+    ThreatSearch threatSearch(THREAT_DEPTH, threatNodes);
+    ThreatSearch::Result threat = threatSearch.solve(grid, aiPlayer);
+    if (threat.outcome == ThreatSearch::Outcome::WIN) {
+        finalMove = Move(HexGrid::fromIndex(threat.move), aiPlayer);
+        isProvenWin = true;
+        isWinningMove = finishesGame(grid, finalMove.coord, aiPlayer);
+        
+        auto endTime = std::chrono::high_resolution_clock::now();
+        int thinkTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+        
+        return MoveInfo{
+            finalMove,
+            isWinningMove ? 10000.0 : PROVEN_WIN_SCORE,
+            threat.nodes,
+            0,
+            1.0,
+            thinkTime,
+            isWinningMove,
+            isBlockingMove,
+            isProvenWin,
+            0,
+            0,
+            0.0,
+            0.0,
+            0,
+            0,
+            0,
+            ponderHit,
+            ponderTime
+        };
     }
     
-    int depth = 4;  // Balanced depth for speed + strength
-    if (moveCount < 6) {
-        depth = 3;  // Early game - many options, use shallower search
-    } else if (moveCount > HexGrid::BOARD_SIZE * HexGrid::BOARD_SIZE - 15) {
-        depth = 5;  // Endgame - fewer options, can search deeper
+    // PRIORITY 4: Near the end, solve the position outright. Decided
+    // positions need no heuristic search: play the win, or when lost the
+    // defence that holds out longest.
+    if (grid.getEmptyCount() <= solverMaxEmptyCells) {
+        long long solverNodes = std::min(solverNodeBudget, (long long)(moveTimeMs / 8) * SOLVER_NODES_PER_MS);
+        EndgameSolver::Result solved = solver.solve(grid, solverNodes);
+        if (solved.outcome != EndgameSolver::Outcome::UNKNOWN && solved.move >= 0) {
+            bool won = solved.outcome == EndgameSolver::Outcome::WIN;
+            finalMove = Move(HexGrid::fromIndex(solved.move), aiPlayer);
+            isProvenWin = won;
+            isWinningMove = won && finishesGame(grid, finalMove.coord, aiPlayer);
+            
+            auto endTime = std::chrono::high_resolution_clock::now();
+            int thinkTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+            
+            return MoveInfo{
+                finalMove,
+                won ? (isWinningMove ? 10000.0 : PROVEN_WIN_SCORE) : -10000.0,
+                (int)solved.nodes,
+                0,
+                won ? 1.0 : 0.0,
+                thinkTime,
+                isWinningMove,
+                isBlockingMove,
+                isProvenWin,
+                0,
+                0,
+                0.0,
+                0.0,
+                0,
+                0,
+                0,
+                ponderHit,
+                ponderTime
+            };
+        }
     }
     
-    int sims = 30;  // Reduced from 50 for speed
+    // If the opponent has a forced win of their own, only the moves that
+    // break it are worth searching
+    std::vector<HexCoord> defences = threatSearch.findDefences(grid, aiPlayer, InferiorCells::candidateMoves(grid),
+                                                               threatNodes);
+    isBlockingMove = !defences.empty();
+    
+    // PRIORITY 5: Iterative-deepening Minimax (primary) + Monte Carlo (validation)
+    // Minimax gets most of the move budget, less what the checks above used,
+    // and goes as deep as it can in that time (naturally deeper in the
+    // endgame, where there are fewer options). Monte Carlo runs alongside it
+    // on its own copy of the board, in either mode for a quarter of the move
+    // time and never past Minimax's deadline.
+    // After a ponder hit the table already holds this search's early
+    // iterations, so the pondering time is taken off the budget.
+    int elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    // Both stay at least 1 ms, since a 0 budget would mean "no limit"
+    int budgetMs = std::max({1, moveTimeMs / 4, moveTimeMs * 3 / 4 - elapsedMs - ponderTime});
+    int monteCarloBudgetMs = std::max(1, std::min(moveTimeMs / 4, budgetMs));
+    SearchLimits limits{MAX_SEARCH_DEPTH, budgetMs, 0};
     
-    MinimaxResult minimaxResult = minimax.findBestMove(grid, depth);
-    MonteCarloResult mcResult = monteCarlo.findBestMove(grid, sims);
+    HexGrid monteCarloGrid(grid);
+    MonteCarloResult mcResult;
+    int monteCarloTime = 0;
+    std::thread monteCarloThread([&]() {
+        auto mcStart = std::chrono::high_resolution_clock::now();
+        mcResult = (monteCarloMode == MonteCarloMode::TREE)
+            ? monteCarlo.findBestMoveUCT(monteCarloGrid, 0, monteCarloBudgetMs)
+            : monteCarlo.findBestMove(monteCarloGrid, 0, monteCarloBudgetMs);
+        monteCarloTime = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - mcStart).count();
+    });
+    
+    auto minimaxStart = std::chrono::high_resolution_clock::now();
+    MinimaxResult minimaxResult = minimax.findBestMove(grid, limits, defences);
+    int minimaxTime = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - minimaxStart).count();
+    monteCarloThread.join();
+    int idleTime = std::abs(minimaxTime - monteCarloTime);
     
     // Use Minimax as primary decision (it's better at tactics)
-    // Only override if Monte Carlo has VERY high confidence AND disagrees
-    if (mcResult.winRate > 0.85 && !(minimaxResult.move.coord == mcResult.move.coord)) {
+    // Only override if Monte Carlo has VERY high confidence AND disagrees,
+    // and never with a move that leaves the opponent's threats standing
+    bool mcDefends = defences.empty() ||
+        std::find(defences.begin(), defences.end(), mcResult.move.coord) != defences.end();
+    if (mcResult.winRate > 0.85 && mcDefends && !(minimaxResult.move.coord == mcResult.move.coord)) {
         // Monte Carlo is very confident - consider its suggestion
         finalMove = mcResult.move;
     } else {
@@ -97,51 +282,36 @@ MoveInfo AI::calculateMove(HexGrid& grid) {
         mcResult.winRate,
         thinkTime,
         isWinningMove,
-        isBlockingMove
+        isBlockingMove,
+        isProvenWin,
+        minimaxResult.depthReached,
+        minimaxResult.threads,
+        minimaxResult.nodesPerSecond,
+        mcResult.playoutsPerSecond,
+        minimaxTime,
+        monteCarloTime,
+        idleTime,
+        ponderHit,
+        ponderTime
     };
 }
 
 HexCoord AI::findImmediateWin(HexGrid& grid, Player player) {
-    // OPTIMIZED: Only check cells that are relevant (near player's stones or edges)
+    // A connecting stone touches one of the player's own stones
     std::vector<HexCoord> candidateCells;
-    
-    // Get player's edge cells
-    std::vector<HexCoord> startEdge, goalEdge;
-    if (player == Player::RED) {
-        startEdge = grid.getTopEdge();
-        goalEdge = grid.getBottomEdge();
-    } else {
-        startEdge = grid.getLeftEdge();
-        goalEdge = grid.getRightEdge();
-    }
-    
-    // Check cells near edges and near player's stones (much faster!)
-    for (const auto& kv : grid.getGrid()) {
-        if (kv.second == Player::NONE) {
-            // Check if this empty cell is adjacent to player's stone
-            bool isRelevant = false;
-            std::vector<HexCoord> neighbors = grid.getNeighbors(kv.first);
-            for (const HexCoord& n : neighbors) {
-                if (grid.getCell(n) == player) {
-                    isRelevant = true;
-                    break;
-                }
-            }
-            
-            if (isRelevant) {
-                candidateCells.push_back(kv.first);
+    for (int index : grid.getEmptyCells()) {
+        for (int n : HexGrid::getNeighborIndices(index)) {
+            if (grid.getCell(n) == player) {
+                candidateCells.push_back(HexGrid::fromIndex(index));
+                break;
             }
         }
     }
     
-    // Quick check on only relevant cells
-    for (const HexCoord& coord : candidateCells) {
-        // Simulate AI move using the safe simulateMove method
-        grid.simulateMove(coord, player);
-        Player winner = grid.getWinner();
-        grid.undoSimulation(coord);
-        
-        if (winner == player) {
+    // Tried in the scorer's order. Minimax orders its root from the same
+    // cached scores, so the lookup is not wasted.
+    for (const HexCoord& coord : scorer->orderMoves(grid, candidateCells, player)) {
+        if (finishesGame(grid, coord, player)) {
             return coord;
         }
     }
@@ -152,22 +322,19 @@ HexCoord AI::findImmediateBlock(HexGrid& grid, Player opponent) {
     // OPTIMIZED: Only check cells near opponent's stones (much faster!)
     std::vector<HexCoord> candidateCells;
     
-    for (const auto& kv : grid.getGrid()) {
-        if (kv.second == Player::NONE) {
-            // Check if this empty cell is adjacent to opponent's stone
-            bool isRelevant = false;
-            std::vector<HexCoord> neighbors = grid.getNeighbors(kv.first);
-            for (const HexCoord& n : neighbors) {
-                if (grid.getCell(n) == opponent) {
-                    isRelevant = true;
-                    break;
-                }
-            }
-            
-            if (isRelevant) {
-                candidateCells.push_back(kv.first);
+    for (int index : grid.getEmptyCells()) {
+        // Check if this empty cell is adjacent to opponent's stone
+        bool isRelevant = false;
+        for (int n : HexGrid::getNeighborIndices(index)) {
+            if (grid.getCell(n) == opponent) {
+                isRelevant = true;
+                break;
             }
         }
+        
+        if (isRelevant) {
+            candidateCells.push_back(HexGrid::fromIndex(index));
+        }
     }
     
     // Quick check on only relevant cells  
@@ -190,18 +357,25 @@ std::vector<HexCoord> AI::findCriticalCells(HexGrid& grid, Player player) {
     // Find cells that significantly improve connectivity
     double baseConnectivity = PathFinding::calculateConnectivity(grid, player);
     
-    for (const auto& kv : grid.getGrid()) {
-        if (kv.second == Player::NONE) {
-            grid.makeMove(kv.first);
-            double newConnectivity = PathFinding::calculateConnectivity(grid, player);
-            grid.undoMove();
-            
-            // If this move improves connectivity by a lot, it's critical
-            if (newConnectivity - baseConnectivity > 2.0) {
-                criticalCells.push_back(kv.first);
-            }
+    // Each make/undo pair restores the empty set exactly, so iterating it here is safe
+    for (int index : grid.getEmptyCells()) {
+        HexCoord coord = HexGrid::fromIndex(index);
+        grid.makeMove(coord);
+        double newConnectivity = PathFinding::calculateConnectivity(grid, player);
+        grid.undoMove();
+        
+        // If this move improves connectivity by a lot, it's critical
+        if (newConnectivity - baseConnectivity > 2.0) {
+            criticalCells.push_back(coord);
         }
     }
     
     return criticalCells;
 }
+
+bool AI::finishesGame(HexGrid& grid, const HexCoord& move, Player player) {
+    grid.simulateMove(move, player);
+    bool connects = grid.getWinner() == player;
+    grid.undoSimulation(move);
+    return connects;
+}
@@ -1,7 +1,13 @@
 #pragma once
+#include "EndgameSolver.h"
 #include "HexGrid.h"
 #include "Minimax.h"
 #include "MonteCarlo.h"
+#include "MoveScorer.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
 
 struct MoveInfo {
     Move move;
@@ -10,22 +16,99 @@ struct MoveInfo {
     int simulations;
     double winRate;
     int thinkTime;
-    bool isWinningMove;
+    bool isWinningMove;  // the move connects: the game ends with it
     bool isBlockingMove;
+    bool isProvenWin;    // threat search or endgame solver proved the position won
+    int searchDepth;     // Minimax iterative-deepening depth reached
+    int searchThreads;   // Minimax threads (Lazy SMP)
+    double nodesPerSecond;
+    double playoutsPerSecond;
+    int minimaxTime;     // ms each engine ran; the two run side by side
+    int monteCarloTime;
+    int idleTime;        // ms the engine that finished first waited for the other
+    bool ponderHit;      // the opponent played the reply the AI pondered on
+    int ponderTime;      // ms spent searching this very position while pondering (hits only)
 };
 
 class AI {
 public:
     AI();
+    ~AI();
     
     MoveInfo calculateMove(HexGrid& grid);
     
+    // Forget search state (transposition table) carried over from the last game
+    void newGame();
+    
+    // Pondering: while the opponent (to move in `grid`) thinks, search the
+    // position after the reply they are expected to make, on a copy of the
+    // board. calculateMove stops it. If the reply was the one pondered, the
+    // table is already warm and the pondering time counts towards the move;
+    // otherwise the work is simply dropped.
+    void startPondering(const HexGrid& grid);
+    void stopPondering();
+    
+    // Wall-clock budget per move. Minimax (up to 3/4 of it) and Monte Carlo
+    // (up to 1/4) run at the same time, so a move takes about the longer of the two
+    void setMoveTime(int milliseconds) { moveTimeMs = std::max(1, milliseconds); }
+    
+    // Threads for both engines; defaults to the hardware thread count (max 8).
+    // The engines search at the same time, so they split them: Monte Carlo
+    // gets a quarter and Minimax the rest, each at least one
+    void setSearchThreads(int threads) {
+        stopPondering();
+        int monteCarloThreads = std::max(1, threads / 4);
+        minimax.setThreads(threads - monteCarloThreads);
+        monteCarlo.setThreads(monteCarloThreads);
+    }
+    
+    // Leaf evaluator for the Minimax search (connectivity by default)
+    void setEvaluator(EvaluatorType type) {
+        stopPondering();
+        minimax.setEvaluator(type);
+    }
+    
+    // Flat Monte Carlo (default) or UCT tree search for the validation pass
+    void setMonteCarloMode(MonteCarloMode mode) { monteCarloMode = mode; }
+    
+    // Exact solver for positions with at most `maxEmptyCells` empty cells,
+    // expanding up to `nodeBudget` positions per move, and no more than an
+    // eighth of the move time allows (0 cells = off)
+    void setEndgameSolver(int maxEmptyCells, long long nodeBudget) {
+        solverMaxEmptyCells = maxEmptyCells;
+        solverNodeBudget = nodeBudget;
+    }
+    
 private:
+    static const int DEFAULT_MOVE_TIME_MS = 1500;
+    static const int MAX_SEARCH_DEPTH = 16;
+    static const int MAX_DEFAULT_THREADS = 8;
+    static const int THREAT_DEPTH = 4;          // attacker threats per line in the front-end check
+    static const int THREAT_NODES_PER_MS = 80;  // measured on solves of 10+ nodes; bench threat.solve's
+                                                // higher rate is mostly its early distance cut-off
+    static const int SOLVER_MAX_EMPTY_CELLS = 90;
+    static const int SOLVER_NODE_BUDGET = 20000;  // per-move cap; the table carries over between moves
+    static const int SOLVER_NODES_PER_MS = 60;    // measured ~64 on self-play endgames
+    static const int SOLVER_HASH_MB = 16;
+    static constexpr double PROVEN_WIN_SCORE = 9000.0;  // won by force, not yet connected (10000 = connects)
+    
+    int moveTimeMs;
+    MonteCarloMode monteCarloMode;
+    int solverMaxEmptyCells;
+    long long solverNodeBudget;
+    std::shared_ptr<MoveScorer> scorer;  // one cache for both engines and the checks below
     Minimax minimax;
     MonteCarlo monteCarlo;
+    EndgameSolver solver;
+    
+    std::thread ponderThread;
+    std::atomic<bool> ponderStop;
+    HexGrid ponderGrid;  // the game plus the expected reply; owned by ponderThread while it runs
+    std::chrono::steady_clock::time_point ponderSearchStart;  // when the expected position's search began
     
     // Critical move detection
     HexCoord findImmediateWin(HexGrid& grid, Player player);
     HexCoord findImmediateBlock(HexGrid& grid, Player player);
     std::vector<HexCoord> findCriticalCells(HexGrid& grid, Player player);
+    bool finishesGame(HexGrid& grid, const HexCoord& move, Player player);
 };
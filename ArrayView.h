@@ -0,0 +1,19 @@
+#pragma once
+
+// Non-owning view over a contiguous run of elements (neighbour and edge
+// tables). Iterates like a container but never allocates.
+template<typename T>
+class ArrayView {
+public:
+    constexpr ArrayView(const T* data, int count) : first(data), count(count) {}
+
+    constexpr const T* begin() const { return first; }
+    constexpr const T* end() const { return first + count; }
+    constexpr int size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+    constexpr const T& operator[](int i) const { return first[i]; }
+
+private:
+    const T* first;
+    int count;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+
+// 128-bit cell set over the flat board index (index = r * BOARD_SIZE + q).
+// An 11x11 board needs 121 bits, so two 64-bit words cover it.
+struct Bitboard {
+    uint64_t lo, hi;
+
+    constexpr Bitboard() : lo(0), hi(0) {}
+    constexpr Bitboard(uint64_t lo, uint64_t hi) : lo(lo), hi(hi) {}
+
+    bool test(int index) const {
+        return index < 64 ? ((lo >> index) & 1) != 0 : ((hi >> (index - 64)) & 1) != 0;
+    }
+
+    constexpr void set(int index) {
+        if (index < 64) lo |= (uint64_t)1 << index;
+        else hi |= (uint64_t)1 << (index - 64);
+    }
+
+    void reset(int index) {
+        if (index < 64) lo &= ~((uint64_t)1 << index);
+        else hi &= ~((uint64_t)1 << (index - 64));
+    }
+
+    bool any() const { return (lo | hi) != 0; }
+
+    int count() const {
+#if defined(__GNUC__)
+        return __builtin_popcountll(lo) + __builtin_popcountll(hi);
+#else
+        int n = 0;
+        for (uint64_t w = lo; w; w &= w - 1) n++;
+        for (uint64_t w = hi; w; w &= w - 1) n++;
+        return n;
+#endif
+    }
+
+    constexpr Bitboard operator|(const Bitboard& o) const { return Bitboard(lo | o.lo, hi | o.hi); }
+    constexpr Bitboard operator&(const Bitboard& o) const { return Bitboard(lo & o.lo, hi & o.hi); }
+    constexpr Bitboard operator^(const Bitboard& o) const { return Bitboard(lo ^ o.lo, hi ^ o.hi); }
+    constexpr Bitboard operator~() const { return Bitboard(~lo, ~hi); }
+    Bitboard& operator|=(const Bitboard& o) { lo |= o.lo; hi |= o.hi; return *this; }
+    Bitboard& operator&=(const Bitboard& o) { lo &= o.lo; hi &= o.hi; return *this; }
+
+    bool operator==(const Bitboard& o) const { return lo == o.lo && hi == o.hi; }
+    bool operator!=(const Bitboard& o) const { return !(*this == o); }
+    
+    // Whole-board shifts towards higher / lower indices, 0 < n < 64
+    Bitboard shiftUp(int n) const { return Bitboard(lo << n, (hi << n) | (lo >> (64 - n))); }
+    Bitboard shiftDown(int n) const { return Bitboard((lo >> n) | (hi << (64 - n)), hi >> n); }
+};
@@ -0,0 +1,198 @@
+#include "EndgameSolver.h"
+#include "InferiorCells.h"
+#include "PathFinding.h"
+#include <algorithm>
+
+namespace {
+    const uint32_t INFINITE_PN = 1u << 30;
+
+    // Empty cells where `player` connects at once: next to (or on) the start
+    // edge's group and next to (or on) the goal edge's group
+    Bitboard winningCells(const HexGrid& grid, Player player) {
+        bool red = (player == Player::RED);
+        const Bitboard& own = grid.getStones(player);
+        const Bitboard& startEdge = red ? HexGrid::TOP_ROW : HexGrid::LEFT_COLUMN;
+        const Bitboard& goalEdge = red ? HexGrid::BOTTOM_ROW : HexGrid::RIGHT_COLUMN;
+        Bitboard fromStart = HexGrid::floodFill(startEdge & own, own);
+        Bitboard fromGoal = HexGrid::floodFill(goalEdge & own, own);
+        Bitboard empty = HexGrid::ALL_CELLS & ~(grid.getStones(Player::RED) | grid.getStones(Player::BLUE));
+        return (HexGrid::dilate(fromStart) | startEdge) & (HexGrid::dilate(fromGoal) | goalEdge) & empty;
+    }
+
+    int firstCell(const HexGrid& grid, const Bitboard& cells) {
+        for (int index : grid.getEmptyCells()) {
+            if (cells.test(index)) return index;
+        }
+        return -1;
+    }
+}
+
+EndgameSolver::EndgameSolver(size_t hashMegabytes) : bucketMask(0), nodes(0), budget(0) {
+    size_t bytes = (hashMegabytes > 0 ? hashMegabytes : 1) * 1024 * 1024;
+    size_t maxBuckets = bytes / (sizeof(Entry) * BUCKET_SIZE);
+    size_t buckets = 1;
+    while (buckets * 2 <= maxBuckets) {
+        buckets *= 2;
+    }
+    table.reset(new Entry[buckets * BUCKET_SIZE]);
+    bucketMask = buckets - 1;
+    clear();
+}
+
+void EndgameSolver::clear() {
+    for (size_t i = 0; i < (bucketMask + 1) * BUCKET_SIZE; ++i) {
+        // Key 0 is a real position (the empty board), so blank entries
+        // carry the same numbers as a miss
+        table[i] = Entry{0, 1, 1, 0, -1};
+    }
+}
+
+const EndgameSolver::Entry* EndgameSolver::find(uint64_t key) const {
+    const Entry* bucket = &table[(key & bucketMask) * BUCKET_SIZE];
+    for (int i = 0; i < BUCKET_SIZE; ++i) {
+        if (bucket[i].key == key) return &bucket[i];
+    }
+    return nullptr;
+}
+
+void EndgameSolver::lookup(uint64_t key, uint32_t& proof, uint32_t& disproof) const {
+    const Entry* entry = find(key);
+    proof = entry ? entry->proof : 1;
+    disproof = entry ? entry->disproof : 1;
+}
+
+void EndgameSolver::store(uint64_t key, uint32_t proof, uint32_t disproof, uint32_t work, int move) {
+    // Same position in place; otherwise evict the entry with less work behind it
+    Entry* bucket = &table[(key & bucketMask) * BUCKET_SIZE];
+    Entry* slot = &bucket[0];
+    for (int i = 0; i < BUCKET_SIZE; ++i) {
+        if (bucket[i].key == key) {
+            slot = &bucket[i];
+            break;
+        }
+        if (bucket[i].work < slot->work) slot = &bucket[i];
+    }
+    *slot = Entry{key, proof, disproof, work, (int16_t)move};
+}
+
+EndgameSolver::Result EndgameSolver::solve(HexGrid& grid, long long nodeBudget) {
+    nodes = 0;
+    budget = nodeBudget;
+    uint32_t proof, disproof;
+    search(grid, INFINITE_PN, INFINITE_PN, true, proof, disproof);
+
+    const Entry* root = find(grid.getHash());
+    if (proof == 0 && root) {
+        // Any reply proven lost for the opponent wins; the one whose proof
+        // took least work is likely the quickest. An immediate win was
+        // never searched below and stays.
+        int move = root->move;
+        const Entry* chosen = move >= 0 ? find(grid.hashAfterMove(move)) : nullptr;
+        uint32_t leastWork = chosen ? chosen->work : 0;
+        for (int index : grid.getEmptyCells()) {
+            const Entry* child = find(grid.hashAfterMove(index));
+            if (child && child->disproof == 0 && child->work < leastWork) {
+                leastWork = child->work;
+                move = index;
+            }
+        }
+        return Result{Outcome::WIN, move, nodes};
+    }
+    if (disproof != 0) return Result{Outcome::UNKNOWN, -1, nodes};
+
+    // Lost: resist with the reply that took the most work to refute
+    int move = -1;
+    uint32_t mostWork = 0;
+    for (int index : grid.getEmptyCells()) {
+        const Entry* child = find(grid.hashAfterMove(index));
+        if (child && child->work >= mostWork) {
+            mostWork = child->work;
+            move = index;
+        }
+    }
+    return Result{Outcome::LOSS, move, nodes};
+}
+
+void EndgameSolver::search(HexGrid& grid, uint32_t proofLimit, uint32_t disproofLimit, bool root,
+                           uint32_t& proof, uint32_t& disproof) {
+    uint64_t key = grid.getHash();
+    long long startNodes = nodes++;
+    Player player = grid.getCurrentPlayer();
+    Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
+
+    // Ends the line with a proven result
+    auto settle = [&](bool won, int move) {
+        proof = won ? 0 : INFINITE_PN;
+        disproof = won ? INFINITE_PN : 0;
+        store(key, proof, disproof, 1, move);
+    };
+
+    // Someone has connected: it can only be the player who just moved
+    if (grid.getWinner() != Player::NONE) return settle(false, -1);
+
+    Bitboard wins = winningCells(grid, player);
+    if (wins.any()) return settle(true, firstCell(grid, wins));
+
+    // Two winning cells for the opponent can't both be blocked; one must be
+    Bitboard threats = winningCells(grid, opponent);
+    int threatCount = threats.count();
+    if (threatCount >= 2) return settle(false, -1);
+
+    int cells[HexGrid::CELL_COUNT];
+    int count = 0;
+    if (threatCount == 1) {
+        cells[count++] = firstCell(grid, threats);
+    } else {
+        InferiorCells::Analysis analysis;
+        InferiorCells::analyze(grid, analysis);
+        if (analysis.filledWinner == opponent) return settle(false, -1);
+        // Won by fill-in, but the root still needs an actual move
+        if (analysis.filledWinner == player && !root) return settle(true, -1);
+        for (int index : grid.getEmptyCells()) {
+            if (analysis.candidates.test(index)) cells[count++] = index;
+        }
+    }
+
+    // Children are read from the table once. Afterwards only the child just
+    // searched can change (proofs never go stale), so it alone is updated.
+    uint32_t childProof[HexGrid::CELL_COUNT], childDisproof[HexGrid::CELL_COUNT];
+    for (int i = 0; i < count; ++i) {
+        lookup(grid.hashAfterMove(cells[i]), childProof[i], childDisproof[i]);
+    }
+
+    while (true) {
+        // proof = smallest child disproof, disproof = sum of child proofs
+        proof = INFINITE_PN;
+        disproof = 0;
+        uint32_t secondDisproof = INFINITE_PN;
+        int best = 0;
+        for (int i = 0; i < count; ++i) {
+            disproof = std::min(INFINITE_PN, disproof + childProof[i]);
+            if (childDisproof[i] < proof) {
+                secondDisproof = proof;
+                proof = childDisproof[i];
+                best = i;
+            } else if (childDisproof[i] < secondDisproof) {
+                secondDisproof = childDisproof[i];
+            }
+        }
+
+        if (proof >= proofLimit || disproof >= disproofLimit || nodes >= budget) {
+            uint32_t work = (uint32_t)std::min<long long>(nodes - startNodes, UINT32_MAX);
+            store(key, proof, disproof, work, proof == 0 ? cells[best] : -1);
+            return;
+        }
+
+        // The child may use up the parent's slack; its disproof threshold
+        // sits a quarter above the runner-up (1 + epsilon trick), so the
+        // search does not flip between two close siblings at every step
+        uint64_t childProofLimit = (uint64_t)disproofLimit - disproof + childProof[best];
+        uint64_t childDisproofLimit = (uint64_t)secondDisproof + secondDisproof / 4 + 1;
+        HexCoord move = HexGrid::fromIndex(cells[best]);
+        grid.makeMove(move);
+        search(grid, (uint32_t)std::min<uint64_t>(INFINITE_PN, childProofLimit),
+               (uint32_t)std::min<uint64_t>(proofLimit, childDisproofLimit), false,
+               childProof[best], childDisproof[best]);
+        grid.undoMove();
+    }
+}
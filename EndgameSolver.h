@@ -0,0 +1,63 @@
+#pragma once
+#include "HexGrid.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Exact endgame solver: depth-first proof-number search (df-pn).
+//   - Every position has a proof number (how many leaves must still be
+//     shown won for the side to move) and a disproof number (how many
+//     must be shown lost). A node's proof number is the smallest disproof
+//     number of its children, its disproof number the sum of their proof
+//     numbers; a proof is 0 / infinity.
+//   - df-pn always descends into the child with the smallest disproof
+//     number, and only returns once the parent's numbers would cross the
+//     thresholds it was given. The numbers live in the solver's own table,
+//     so the depth-first walk can stop and resume anywhere.
+// Move generation uses the InferiorCells candidates, and a fill-in that
+// already connects one side ends the line. A side one stone from
+// connecting wins. A side that faces two such cells loses; facing one
+// it must block.
+class EndgameSolver {
+public:
+    enum class Outcome { UNKNOWN, WIN, LOSS };   // for the player to move
+
+    struct Result {
+        Outcome outcome;
+        int move;          // WIN: the winning cell with the cheapest proof.
+                           // LOSS: the reply that took longest to refute. -1 if none
+        long long nodes;   // positions expanded
+    };
+
+    explicit EndgameSolver(size_t hashMegabytes = 8);
+
+    // Solves `grid` for the side to move, expanding at most `nodeBudget`
+    // positions. The grid is restored.
+    Result solve(HexGrid& grid, long long nodeBudget);
+
+    // Proof numbers carry over between calls; clear them when a new game starts
+    void clear();
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint32_t proof;
+        uint32_t disproof;
+        uint32_t work;     // positions expanded below this one, for replacement
+        int16_t move;      // winning cell once proven, else -1
+    };
+
+    static const int BUCKET_SIZE = 2;
+
+    std::unique_ptr<Entry[]> table;
+    size_t bucketMask;
+    long long nodes;
+    long long budget;
+
+    // Runs until the node's numbers reach a limit and returns them
+    void search(HexGrid& grid, uint32_t proofLimit, uint32_t disproofLimit, bool root,
+                uint32_t& proof, uint32_t& disproof);
+    void lookup(uint64_t key, uint32_t& proof, uint32_t& disproof) const;
+    void store(uint64_t key, uint32_t proof, uint32_t disproof, uint32_t work, int move);
+    const Entry* find(uint64_t key) const;
+};
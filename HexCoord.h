@@ -6,14 +6,14 @@
 struct HexCoord {
     int q, r;
     
-    HexCoord() : q(0), r(0) {}
-    HexCoord(int q, int r) : q(q), r(r) {}
+    constexpr HexCoord() : q(0), r(0) {}
+    constexpr HexCoord(int q, int r) : q(q), r(r) {}
     
-    bool operator==(const HexCoord& other) const {
+    constexpr bool operator==(const HexCoord& other) const {
         return q == other.q && r == other.r;
     }
     
-    bool operator!=(const HexCoord& other) const {
+    constexpr bool operator!=(const HexCoord& other) const {
         return !(*this == other);
     }
     
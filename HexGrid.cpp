@@ -1,39 +1,197 @@
 #include "HexGrid.h"
-#include <queue>
-#include <unordered_set>
+#include <utility>
 
-const HexCoord HexGrid::DIRECTIONS[6] = {
-    HexCoord(1, 0), HexCoord(1, -1), HexCoord(0, -1),
-    HexCoord(-1, 0), HexCoord(-1, 1), HexCoord(0, 1)
-};
+// SSE2 is part of every x86-64 target; define HEX_NO_SIMD to force the
+// portable two-word flood fill
+#if !defined(HEX_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define HEX_FLOOD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+constexpr HexGrid::AdjacencyTable::AdjacencyTable() : counts{}, indices{}, coords{} {
+    const int DQ[6] = {1, 1, 0, -1, -1, 0};
+    const int DR[6] = {0, -1, -1, 0, 1, 1};
+    for (int index = 0; index < CELL_COUNT; ++index) {
+        int q = index % BOARD_SIZE;
+        int r = index / BOARD_SIZE;
+        int n = 0;
+        for (int d = 0; d < 6; ++d) {
+            int nq = q + DQ[d];
+            int nr = r + DR[d];
+            if (nq < 0 || nq >= BOARD_SIZE || nr < 0 || nr >= BOARD_SIZE) continue;
+            indices[index][n] = (uint8_t)(nr * BOARD_SIZE + nq);
+            coords[index][n] = HexCoord(nq, nr);
+            n++;
+        }
+        counts[index] = (uint8_t)n;
+    }
+}
+
+constexpr HexGrid::EdgeTable::EdgeTable() : top{}, bottom{}, left{}, right{} {
+    for (int i = 0; i < BOARD_SIZE; ++i) {
+        top[i] = HexCoord(i, 0);
+        bottom[i] = HexCoord(i, BOARD_SIZE - 1);
+        left[i] = HexCoord(0, i);
+        right[i] = HexCoord(BOARD_SIZE - 1, i);
+    }
+}
+
+// Constant-initialized: both tables are filled in by the compiler
+constexpr HexGrid::AdjacencyTable HexGrid::ADJACENCY;
+constexpr HexGrid::EdgeTable HexGrid::EDGES;
+
+namespace {
+    constexpr Bitboard cellRect(int qMin, int qMax, int rMin, int rMax) {
+        Bitboard cells;
+        for (int r = rMin; r <= rMax; ++r) {
+            for (int q = qMin; q <= qMax; ++q) {
+                cells.set(r * HexGrid::BOARD_SIZE + q);
+            }
+        }
+        return cells;
+    }
+    
+    const int LAST = HexGrid::BOARD_SIZE - 1;
+    constexpr Bitboard NOT_FIRST_COLUMN = cellRect(1, LAST, 0, LAST);  // cells with a q - 1 neighbour
+    constexpr Bitboard NOT_LAST_COLUMN = cellRect(0, LAST - 1, 0, LAST);  // cells with a q + 1 neighbour
+}
+
+constexpr Bitboard HexGrid::TOP_ROW = cellRect(0, LAST, 0, 0);
+constexpr Bitboard HexGrid::BOTTOM_ROW = cellRect(0, LAST, LAST, LAST);
+constexpr Bitboard HexGrid::LEFT_COLUMN = cellRect(0, 0, 0, LAST);
+constexpr Bitboard HexGrid::RIGHT_COLUMN = cellRect(LAST, LAST, 0, LAST);
+constexpr Bitboard HexGrid::ALL_CELLS = cellRect(0, LAST, 0, LAST);
+
+// With index = r * N + q the six neighbours sit at index +-1 (q +- 1),
+// +-N (r +- 1), -(N - 1) (q + 1, r - 1) and +(N - 1) (q - 1, r + 1).
+// Column masks stop the +-1 and +-(N - 1) shifts wrapping across rows.
+Bitboard HexGrid::dilate(const Bitboard& cells) {
+    Bitboard east = cells & NOT_LAST_COLUMN;
+    Bitboard west = cells & NOT_FIRST_COLUMN;
+    return (cells | east.shiftUp(1) | west.shiftDown(1)
+                  | cells.shiftUp(BOARD_SIZE) | cells.shiftDown(BOARD_SIZE)
+                  | east.shiftDown(BOARD_SIZE - 1) | west.shiftUp(BOARD_SIZE - 1))
+           & ALL_CELLS;
+}
+
+#ifdef HEX_FLOOD_SSE2
+namespace {
+    inline __m128i load(const Bitboard& b) { return _mm_set_epi64x((long long)b.hi, (long long)b.lo); }
+    
+    // Full 128-bit shifts built from the per-lane 64-bit shifts
+    template<int N> inline __m128i shiftUp(__m128i v) {
+        return _mm_or_si128(_mm_slli_epi64(v, N), _mm_srli_epi64(_mm_slli_si128(v, 8), 64 - N));
+    }
+    template<int N> inline __m128i shiftDown(__m128i v) {
+        return _mm_or_si128(_mm_srli_epi64(v, N), _mm_slli_epi64(_mm_srli_si128(v, 8), 64 - N));
+    }
+    
+    inline bool isZero(__m128i v) {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xFFFF;
+    }
+}
+
+Bitboard HexGrid::floodFill(const Bitboard& seeds, const Bitboard& mask, const Bitboard& target) {
+    const int N = BOARD_SIZE;
+    const __m128i m = load(mask & ALL_CELLS);
+    const __m128i t = load(target);
+    const __m128i notFirst = load(NOT_FIRST_COLUMN);
+    const __m128i notLast = load(NOT_LAST_COLUMN);
+    __m128i reach = _mm_and_si128(load(seeds), m);
+    
+    while (isZero(_mm_and_si128(reach, t))) {
+        __m128i east = _mm_and_si128(reach, notLast);
+        __m128i west = _mm_and_si128(reach, notFirst);
+        __m128i next = _mm_or_si128(_mm_or_si128(_mm_or_si128(reach, shiftUp<1>(east)),
+                                                 _mm_or_si128(shiftDown<1>(west), shiftUp<N>(reach))),
+                                    _mm_or_si128(_mm_or_si128(shiftDown<N>(reach), shiftDown<N - 1>(east)),
+                                                 shiftUp<N - 1>(west)));
+        next = _mm_and_si128(next, m);  // Also clips bits shifted past the last cell
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(next, reach)) == 0xFFFF) break;
+        reach = next;
+    }
+    
+    alignas(16) uint64_t words[2];
+    _mm_store_si128((__m128i*)words, reach);
+    return Bitboard(words[0], words[1]);
+}
+#else
+Bitboard HexGrid::floodFill(const Bitboard& seeds, const Bitboard& mask, const Bitboard& target) {
+    Bitboard reach = seeds & mask;
+    while (!(reach & target).any()) {
+        Bitboard next = dilate(reach) & mask;
+        if (next == reach) break;
+        reach = next;
+    }
+    return reach;
+}
+#endif
+
+namespace {
+    // Zobrist keys, generated at compile time with SplitMix64 so every build
+    // (and every process) hashes the same position to the same key
+    struct ZobristKeys {
+        uint64_t stones[2][HexGrid::CELL_COUNT];
+        uint64_t blueToMove;
+        
+        constexpr ZobristKeys() : stones{}, blueToMove(0) {
+            uint64_t state = 0x2545F4914F6CDD1DULL;
+            for (int p = 0; p < 2; ++p) {
+                for (int i = 0; i < HexGrid::CELL_COUNT; ++i) {
+                    stones[p][i] = next(state);
+                }
+            }
+            blueToMove = next(state);
+        }
+        
+        static constexpr uint64_t next(uint64_t& state) {
+            state += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+    };
+    
+    constexpr ZobristKeys ZOBRIST;
+}
 
 HexGrid::HexGrid() : currentPlayer(Player::RED) {
+    placements.reserve(CELL_COUNT);
+    unionLog.reserve(CELL_COUNT * 4);
     reset();
 }
 
 void HexGrid::reset() {
-    grid.clear();
-    for (int q = 0; q < BOARD_SIZE; ++q) {
-        for (int r = 0; r < BOARD_SIZE; ++r) {
-            grid[HexCoord(q, r)] = Player::NONE;
-        }
-    }
+    stones[0] = Bitboard();
+    stones[1] = Bitboard();
     currentPlayer = Player::RED;
+    hashKey = 0;
     moveHistory.clear();
+    resetEmptyCells();
+    resetConnectivity();
+}
+
+void HexGrid::resetEmptyCells() {
+    for (int i = 0; i < CELL_COUNT; ++i) {
+        emptyCells[i] = (uint8_t)i;
+        emptyPosition[i] = (uint8_t)i;
+    }
+    emptyCount = CELL_COUNT;
+    stoneCount[0] = 0;
+    stoneCount[1] = 0;
 }
 
 Player HexGrid::getCell(const HexCoord& coord) const {
-    auto it = grid.find(coord);
-    return (it != grid.end()) ? it->second : Player::NONE;
+    return isValid(coord) ? getCell(toIndex(coord)) : Player::NONE;
 }
 
 bool HexGrid::makeMove(const HexCoord& coord) {
-    auto it = grid.find(coord);
-    if (it != grid.end() && it->second == Player::NONE) {
+    if (isValid(coord) && getCell(toIndex(coord)) == Player::NONE) {
         Move move(coord, currentPlayer);
-        grid[coord] = currentPlayer;
+        placeStone(toIndex(coord), currentPlayer);
         moveHistory.push_back(move);
-        currentPlayer = (currentPlayer == Player::RED) ? Player::BLUE : Player::RED;
+        setCurrentPlayer((currentPlayer == Player::RED) ? Player::BLUE : Player::RED);
         return true;
     }
     return false;
@@ -41,10 +199,9 @@ bool HexGrid::makeMove(const HexCoord& coord) {
 
 // Place a move explicitly for the given player (used ONLY for simulation - doesn't change turn)
 bool HexGrid::makeMoveFor(const HexCoord& coord, Player player) {
-    auto it = grid.find(coord);
-    if (it != grid.end() && it->second == Player::NONE) {
+    if (isValid(coord) && getCell(toIndex(coord)) == Player::NONE) {
         Move move(coord, player);
-        grid[coord] = player;
+        placeStone(toIndex(coord), player);
         moveHistory.push_back(move);
         // DON'T change currentPlayer - this is for simulation only!
         // The calling code will handle turn management properly
@@ -55,111 +212,165 @@ bool HexGrid::makeMoveFor(const HexCoord& coord, Player player) {
 
 // Simulate a move without affecting move history (safer for AI evaluation)
 bool HexGrid::simulateMove(const HexCoord& coord, Player player) {
-    auto it = grid.find(coord);
-    if (it != grid.end() && it->second == Player::NONE) {
-        grid[coord] = player;
+    if (isValid(coord) && getCell(toIndex(coord)) == Player::NONE) {
+        placeStone(toIndex(coord), player);
         return true;
     }
     return false;
 }
 
 void HexGrid::undoSimulation(const HexCoord& coord) {
-    grid[coord] = Player::NONE;
+    if (isValid(coord) && getCell(toIndex(coord)) != Player::NONE) {
+        removeStone(toIndex(coord));
+    }
+}
+
+void HexGrid::setCurrentPlayer(Player player) {
+    if (player != currentPlayer) {
+        hashKey ^= ZOBRIST.blueToMove;
+        currentPlayer = player;
+    }
 }
 
 void HexGrid::undoMove() {
     if (!moveHistory.empty()) {
         Move lastMove = moveHistory.back();
         moveHistory.pop_back();
-        grid[lastMove.coord] = Player::NONE;
-        currentPlayer = lastMove.player;
+        removeStone(toIndex(lastMove.coord));
+        setCurrentPlayer(lastMove.player);
     }
 }
 
-std::vector<HexCoord> HexGrid::getNeighbors(const HexCoord& coord) const {
-    std::vector<HexCoord> neighbors;
-    for (int i = 0; i < 6; ++i) {
-        HexCoord neighbor(coord.q + DIRECTIONS[i].q, coord.r + DIRECTIONS[i].r);
-        if (grid.find(neighbor) != grid.end()) {
-            neighbors.push_back(neighbor);
-        }
-    }
-    return neighbors;
-}
+// ---------------------------------------------------------------------------
+// Incremental connectivity: union-find over same-colour stones plus four
+// virtual edge nodes. Union by size without path compression keeps every
+// union a single parent-pointer write, so undo is a straight log rollback.
+// ---------------------------------------------------------------------------
 
-std::vector<HexCoord> HexGrid::getTopEdge() const {
-    std::vector<HexCoord> edge;
-    for (int q = 0; q < BOARD_SIZE; ++q) {
-        edge.push_back(HexCoord(q, 0));
+void HexGrid::resetConnectivity() {
+    for (int i = 0; i < UF_NODES; ++i) {
+        ufParent[i] = i;
+        ufSize[i] = 1;
     }
-    return edge;
+    placements.clear();
+    unionLog.clear();
+    winner = Player::NONE;
 }
 
-std::vector<HexCoord> HexGrid::getBottomEdge() const {
-    std::vector<HexCoord> edge;
-    for (int q = 0; q < BOARD_SIZE; ++q) {
-        edge.push_back(HexCoord(q, BOARD_SIZE - 1));
+int HexGrid::findRoot(int node) const {
+    while (ufParent[node] != node) {
+        node = ufParent[node];
     }
-    return edge;
+    return node;
 }
 
-std::vector<HexCoord> HexGrid::getLeftEdge() const {
-    std::vector<HexCoord> edge;
-    for (int r = 0; r < BOARD_SIZE; ++r) {
-        edge.push_back(HexCoord(0, r));
-    }
-    return edge;
+void HexGrid::unite(int a, int b) {
+    a = findRoot(a);
+    b = findRoot(b);
+    if (a == b) return;
+    if (ufSize[a] < ufSize[b]) std::swap(a, b);
+    ufParent[b] = a;
+    ufSize[a] += ufSize[b];
+    unionLog.push_back(UnionRecord{b, a});
 }
 
-std::vector<HexCoord> HexGrid::getRightEdge() const {
-    std::vector<HexCoord> edge;
-    for (int r = 0; r < BOARD_SIZE; ++r) {
-        edge.push_back(HexCoord(BOARD_SIZE - 1, r));
+void HexGrid::placeStone(int index, Player player) {
+    int side = (player == Player::RED) ? 0 : 1;
+    stones[side].set(index);
+    stoneCount[side]++;
+    hashKey ^= ZOBRIST.stones[side][index];
+    
+    // Swap the cell to the end of the live range of the empty set
+    int slot = emptyPosition[index];
+    int last = emptyCells[--emptyCount];
+    emptyCells[slot] = (uint8_t)last;
+    emptyPosition[last] = (uint8_t)slot;
+    emptyCells[emptyCount] = (uint8_t)index;
+    emptyPosition[index] = (uint8_t)emptyCount;
+    
+    placements.push_back(Placement{index, (int)unionLog.size(), winner, slot});
+    
+    const Bitboard& own = stones[side];
+    for (int neighbor : getNeighborIndices(index)) {
+        if (own.test(neighbor)) {
+            unite(index, neighbor);
+        }
+    }
+    
+    HexCoord coord = fromIndex(index);
+    
+    if (player == Player::RED) {
+        if (coord.r == 0) unite(index, TOP_NODE);
+        if (coord.r == BOARD_SIZE - 1) unite(index, BOTTOM_NODE);
+        if (winner == Player::NONE && findRoot(TOP_NODE) == findRoot(BOTTOM_NODE)) {
+            winner = Player::RED;
+        }
+    } else {
+        if (coord.q == 0) unite(index, LEFT_NODE);
+        if (coord.q == BOARD_SIZE - 1) unite(index, RIGHT_NODE);
+        if (winner == Player::NONE && findRoot(LEFT_NODE) == findRoot(RIGHT_NODE)) {
+            winner = Player::BLUE;
+        }
     }
-    return edge;
 }
 
-Player HexGrid::getWinner() const {
-    if (hasWinningPath(Player::RED, getTopEdge(), getBottomEdge())) {
-        return Player::RED;
+void HexGrid::removeStone(int index) {
+    int side = stones[0].test(index) ? 0 : 1;
+    stones[side].reset(index);
+    stoneCount[side]--;
+    hashKey ^= ZOBRIST.stones[side][index];
+    
+    if (placements.empty() || placements.back().index != index) {
+        // Not the most recent placement (undo out of order) - rebuild from the bitboards
+        rebuildConnectivity();
+        return;
     }
-    if (hasWinningPath(Player::BLUE, getLeftEdge(), getRightEdge())) {
-        return Player::BLUE;
+    
+    // Most recent placement: the cell still sits just past the live range,
+    // so growing the set and swapping it back restores the previous order
+    const Placement& last = placements.back();
+    int moved = emptyCells[last.emptySlot];
+    emptyCells[last.emptySlot] = (uint8_t)index;
+    emptyPosition[index] = (uint8_t)last.emptySlot;
+    emptyCells[emptyCount] = (uint8_t)moved;
+    emptyPosition[moved] = (uint8_t)emptyCount;
+    emptyCount++;
+    
+    while ((int)unionLog.size() > last.unionLogSize) {
+        const UnionRecord& u = unionLog.back();
+        ufSize[u.root] -= ufSize[u.child];
+        ufParent[u.child] = u.child;
+        unionLog.pop_back();
     }
-    return Player::NONE;
+    winner = last.winnerBefore;
+    placements.pop_back();
 }
 
-bool HexGrid::hasWinningPath(Player player,
-                             const std::vector<HexCoord>& startEdge,
-                             const std::vector<HexCoord>& goalEdge) const {
-    std::unordered_set<HexCoord> goalSet(goalEdge.begin(), goalEdge.end());
-    std::unordered_set<HexCoord> visited;
-    std::queue<HexCoord> queue;
+void HexGrid::rebuildConnectivity() {
+    Bitboard red = stones[0];
+    Bitboard blue = stones[1];
+    stones[0] = Bitboard();
+    stones[1] = Bitboard();
+    hashKey = (currentPlayer == Player::BLUE) ? ZOBRIST.blueToMove : 0;
+    resetEmptyCells();
+    resetConnectivity();
     
-    for (const HexCoord& coord : startEdge) {
-        if (getCell(coord) == player) {
-            queue.push(coord);
-            visited.insert(coord);
-        }
+    for (const Move& move : moveHistory) {
+        int index = toIndex(move.coord);
+        if (red.test(index) && !stones[0].test(index)) placeStone(index, Player::RED);
+        else if (blue.test(index) && !stones[1].test(index)) placeStone(index, Player::BLUE);
     }
-    
-    while (!queue.empty()) {
-        HexCoord current = queue.front();
-        queue.pop();
-        
-        if (goalSet.find(current) != goalSet.end()) {
-            return true;
-        }
-        
-        std::vector<HexCoord> neighbors = getNeighbors(current);
-        for (const HexCoord& neighbor : neighbors) {
-            if (visited.find(neighbor) == visited.end() && 
-                getCell(neighbor) == player) {
-                visited.insert(neighbor);
-                queue.push(neighbor);
-            }
-        }
+    for (int index = 0; index < CELL_COUNT; ++index) {
+        if (red.test(index) && !stones[0].test(index)) placeStone(index, Player::RED);
+        else if (blue.test(index) && !stones[1].test(index)) placeStone(index, Player::BLUE);
     }
-    
-    return false;
+}
+
+uint64_t HexGrid::hashAfterMove(int index) const {
+    int side = (currentPlayer == Player::RED) ? 0 : 1;
+    return hashKey ^ ZOBRIST.stones[side][index] ^ ZOBRIST.blueToMove;
+}
+
+Player HexGrid::getWinner() const {
+    return winner;
 }
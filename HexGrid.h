@@ -1,46 +1,183 @@
 #pragma once
 #include "HexCoord.h"
-#include <unordered_map>
+#include "Bitboard.h"
+#include "ArrayView.h"
+#include <cstdint>
 #include <vector>
 
 class HexGrid {
 public:
     static const int BOARD_SIZE = 11;
-    
+    static const int CELL_COUNT = BOARD_SIZE * BOARD_SIZE;
+
+    // One (coordinate, owner) entry of the flat board view returned by getGrid()
+    struct Cell {
+        HexCoord first;
+        Player second;
+    };
+
+    // Cheap iterable view over all cells in index order (no hashing, no allocation)
+    class CellIterator {
+    public:
+        CellIterator(const HexGrid* grid, int index) : grid(grid), index(index) {}
+        Cell operator*() const { return Cell{fromIndex(index), grid->getCell(index)}; }
+        CellIterator& operator++() { ++index; return *this; }
+        bool operator!=(const CellIterator& other) const { return index != other.index; }
+    private:
+        const HexGrid* grid;
+        int index;
+    };
+
+    class CellRange {
+    public:
+        explicit CellRange(const HexGrid* grid) : grid(grid) {}
+        CellIterator begin() const { return CellIterator(grid, 0); }
+        CellIterator end() const { return CellIterator(grid, CELL_COUNT); }
+        int size() const { return CELL_COUNT; }
+    private:
+        const HexGrid* grid;
+    };
+
     HexGrid();
     void reset();
-    
+
+    // Flat cell index <-> axial coordinate (index = r * BOARD_SIZE + q)
+    static bool isValid(const HexCoord& coord) {
+        return coord.q >= 0 && coord.q < BOARD_SIZE && coord.r >= 0 && coord.r < BOARD_SIZE;
+    }
+    static int toIndex(const HexCoord& coord) { return coord.r * BOARD_SIZE + coord.q; }
+    static HexCoord fromIndex(int index) { return HexCoord(index % BOARD_SIZE, index / BOARD_SIZE); }
+
     Player getCell(const HexCoord& coord) const;
+    Player getCell(int index) const {
+        if (stones[0].test(index)) return Player::RED;
+        if (stones[1].test(index)) return Player::BLUE;
+        return Player::NONE;
+    }
+    const Bitboard& getStones(Player player) const { return stones[player == Player::RED ? 0 : 1]; }
+    int getStoneCount(Player player) const { return stoneCount[player == Player::RED ? 0 : 1]; }
+    
+    // Empty cells as a sparse set: a contiguous array of cell indices kept
+    // up to date by every make/undo/simulate call. The order is arbitrary
+    // (a LIFO undo restores it exactly).
+    ArrayView<uint8_t> getEmptyCells() const { return ArrayView<uint8_t>(emptyCells, emptyCount); }
+    int getEmptyCount() const { return emptyCount; }
+
     bool makeMove(const HexCoord& coord);
     void undoMove();
-    
+
     Player getCurrentPlayer() const { return currentPlayer; }
+
+    // 64-bit Zobrist key of the stones on the board and the side to move,
+    // updated incrementally by every make/undo/simulate call
+    uint64_t getHash() const { return hashKey; }
+    
+    // Key the position would have after the side to move plays `index`
+    // (an empty cell), without playing it
+    uint64_t hashAfterMove(int index) const;
+
+    // O(1): the winner is tracked incrementally by the union-find below
     Player getWinner() const;
+
+    // Adjacency and edge lists come from tables built at compile time;
+    // the views point into static storage and never allocate
+    static ArrayView<uint8_t> getNeighborIndices(int index) {
+        return ArrayView<uint8_t>(ADJACENCY.indices[index], ADJACENCY.counts[index]);
+    }
+    // `coord` must be on the board
+    static ArrayView<HexCoord> getNeighbors(const HexCoord& coord) {
+        int index = toIndex(coord);
+        return ArrayView<HexCoord>(ADJACENCY.coords[index], ADJACENCY.counts[index]);
+    }
+    static ArrayView<HexCoord> getTopEdge() { return ArrayView<HexCoord>(EDGES.top, BOARD_SIZE); }
+    static ArrayView<HexCoord> getBottomEdge() { return ArrayView<HexCoord>(EDGES.bottom, BOARD_SIZE); }
+    static ArrayView<HexCoord> getLeftEdge() { return ArrayView<HexCoord>(EDGES.left, BOARD_SIZE); }
+    static ArrayView<HexCoord> getRightEdge() { return ArrayView<HexCoord>(EDGES.right, BOARD_SIZE); }
+
+    // Edge rows/columns and the whole board as cell sets
+    static const Bitboard TOP_ROW;
+    static const Bitboard BOTTOM_ROW;
+    static const Bitboard LEFT_COLUMN;
+    static const Bitboard RIGHT_COLUMN;
+    static const Bitboard ALL_CELLS;
     
-    std::vector<HexCoord> getNeighbors(const HexCoord& coord) const;
-    std::vector<HexCoord> getTopEdge() const;
-    std::vector<HexCoord> getBottomEdge() const;
-    std::vector<HexCoord> getLeftEdge() const;
-    std::vector<HexCoord> getRightEdge() const;
+    // `cells` plus every on-board neighbour of them (one bit-parallel step)
+    static Bitboard dilate(const Bitboard& cells);
     
-    const std::unordered_map<HexCoord, Player>& getGrid() const { return grid; }
-    const std::vector<Move>& getMoveHistory() const { return moveHistory; }
+    // Bit-parallel flood fill: grows `seeds & mask` through hex adjacency
+    // inside `mask` until it stops changing, or as soon as it touches `target`
+    static Bitboard floodFill(const Bitboard& seeds, const Bitboard& mask, const Bitboard& target = Bitboard());
     
+    CellRange getGrid() const { return CellRange(this); }
+    const std::vector<Move>& getMoveHistory() const { return moveHistory; }
+
     // Place a move for a specific player (used for safe simulation)
     bool makeMoveFor(const HexCoord& coord, Player player);
-    
+
     // Simulate a move without affecting move history (for AI evaluation)
     bool simulateMove(const HexCoord& coord, Player player);
     void undoSimulation(const HexCoord& coord);
-    
+
 private:
-    std::unordered_map<HexCoord, Player> grid;
+    // Virtual union-find nodes for the four board edges
+    static const int TOP_NODE = CELL_COUNT;
+    static const int BOTTOM_NODE = CELL_COUNT + 1;
+    static const int LEFT_NODE = CELL_COUNT + 2;
+    static const int RIGHT_NODE = CELL_COUNT + 3;
+    static const int UF_NODES = CELL_COUNT + 4;
+
+    struct UnionRecord {
+        int child;  // root that was attached
+        int root;   // root it was attached to
+    };
+
+    struct Placement {
+        int index;
+        int unionLogSize;     // unionLog size before this stone was placed
+        Player winnerBefore;
+        int emptySlot;        // position the cell held in emptyCells
+    };
+
+    Bitboard stones[2];  // [0] = RED, [1] = BLUE
+    int stoneCount[2];
+    uint8_t emptyCells[CELL_COUNT];     // emptyCells[0..emptyCount) are the empty cells
+    uint8_t emptyPosition[CELL_COUNT];  // slot of each cell in emptyCells
+    int emptyCount;
     Player currentPlayer;
+    uint64_t hashKey;
     std::vector<Move> moveHistory;
-    
-    static const HexCoord DIRECTIONS[6];
-    
-    bool hasWinningPath(Player player, 
-                       const std::vector<HexCoord>& startEdge,
-                       const std::vector<HexCoord>& goalEdge) const;
+
+    int ufParent[UF_NODES];
+    int ufSize[UF_NODES];
+    std::vector<UnionRecord> unionLog;
+    std::vector<Placement> placements;
+    Player winner;
+
+    struct AdjacencyTable {
+        uint8_t counts[CELL_COUNT];
+        uint8_t indices[CELL_COUNT][6];
+        HexCoord coords[CELL_COUNT][6];
+        constexpr AdjacencyTable();
+    };
+
+    struct EdgeTable {
+        HexCoord top[BOARD_SIZE];
+        HexCoord bottom[BOARD_SIZE];
+        HexCoord left[BOARD_SIZE];
+        HexCoord right[BOARD_SIZE];
+        constexpr EdgeTable();
+    };
+
+    static const AdjacencyTable ADJACENCY;
+    static const EdgeTable EDGES;
+
+    void setCurrentPlayer(Player player);
+    void placeStone(int index, Player player);
+    void removeStone(int index);
+
+    void resetEmptyCells();
+    void resetConnectivity();
+    void rebuildConnectivity();
+    int findRoot(int node) const;
+    void unite(int a, int b);
 };
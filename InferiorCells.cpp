@@ -0,0 +1,190 @@
+#include "InferiorCells.h"
+#include "PathFinding.h"
+
+namespace {
+    const int N = HexGrid::BOARD_SIZE;
+
+    // Directions in cyclic order, so ring bits k and k + 1 are neighbours of
+    // each other as well as of the centre cell
+    const int DQ[6] = {1, 1, 0, -1, -1, 0};
+    const int DR[6] = {0, -1, -1, 0, 1, 1};
+
+    constexpr bool ringBit(int mask, int k) { return ((mask >> (k % 6)) & 1) != 0; }
+
+    constexpr bool deadRing(int own, int other) {
+        for (int k = 0; k < 6; ++k) {
+            if (ringBit(own, k) && ringBit(own, k + 1) && ringBit(own, k + 2)) {
+                if (ringBit(own, k + 3)) return true;
+                if (ringBit(other, k + 3) && ringBit(other, k + 4)) return true;
+                if (ringBit(other, k + 4) && ringBit(other, k + 5)) return true;
+            }
+        }
+        return false;
+    }
+
+    struct RingTable {
+        int8_t neighbor[HexGrid::CELL_COUNT][6];  // -1 when off the board
+        uint8_t edgeRed[HexGrid::CELL_COUNT];     // ring bits lying beyond the top/bottom edge
+        uint8_t edgeBlue[HexGrid::CELL_COUNT];    // ... beyond the left/right edge
+        bool dead[64][64];                        // [red ring][blue ring]
+        bool oneShort[64][64];                    // one more stone of either colour can kill it
+
+        constexpr RingTable() : neighbor{}, edgeRed{}, edgeBlue{}, dead{}, oneShort{} {
+            for (int index = 0; index < HexGrid::CELL_COUNT; ++index) {
+                int q = index % N, r = index / N;
+                for (int k = 0; k < 6; ++k) {
+                    int nq = q + DQ[k], nr = r + DR[k];
+                    bool qIn = nq >= 0 && nq < N, rIn = nr >= 0 && nr < N;
+                    neighbor[index][k] = (qIn && rIn) ? (int8_t)(nr * N + nq) : -1;
+                    // Beyond a corner the owning edge is ambiguous: leave it empty
+                    if (qIn && !rIn) edgeRed[index] |= (uint8_t)(1 << k);
+                    if (!qIn && rIn) edgeBlue[index] |= (uint8_t)(1 << k);
+                }
+            }
+            for (int red = 0; red < 64; ++red) {
+                for (int blue = 0; blue < 64; ++blue) {
+                    dead[red][blue] = !(red & blue) && (deadRing(red, blue) || deadRing(blue, red));
+                }
+            }
+            for (int red = 0; red < 64; ++red) {
+                for (int blue = 0; blue < 64; ++blue) {
+                    for (int k = 0; k < 6; ++k) {
+                        int bit = 1 << k;
+                        if (!((red | blue) & bit) && (dead[red | bit][blue] || dead[red][blue | bit])) {
+                            oneShort[red][blue] = true;
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    constexpr RingTable RINGS;
+
+    // Ring colours of every cell, kept up to date as fill-in adds stones
+    struct Rings {
+        uint8_t colour[2][HexGrid::CELL_COUNT];   // [0] = RED, [1] = BLUE
+
+        bool dead(int cell) const { return RINGS.dead[colour[0][cell]][colour[1][cell]]; }
+        bool oneShort(int cell) const { return RINGS.oneShort[colour[0][cell]][colour[1][cell]]; }
+
+        // Would `cell` be dead if `side` also held its neighbour in direction k?
+        bool deadWith(int cell, int k, int side) const {
+            int red = colour[0][cell], blue = colour[1][cell];
+            if (side == 0) red |= 1 << k;
+            else blue |= 1 << k;
+            return RINGS.dead[red][blue];
+        }
+
+        void place(int cell, int side) {
+            for (int k = 0; k < 6; ++k) {
+                int n = RINGS.neighbor[cell][k];
+                if (n >= 0) colour[side][n] |= (uint8_t)(1 << ((k + 3) % 6));
+            }
+        }
+    };
+}
+
+void InferiorCells::analyze(const HexGrid& grid, Analysis& analysis) {
+    Bitboard empty = HexGrid::ALL_CELLS & ~(grid.getStones(Player::RED) | grid.getStones(Player::BLUE));
+    analysis = Analysis{Bitboard(), {Bitboard(), Bitboard()}, Bitboard(), Bitboard(),
+                        {Bitboard(), Bitboard()}, Player::NONE};
+
+    Rings rings;
+    for (int index = 0; index < HexGrid::CELL_COUNT; ++index) {
+        rings.colour[0][index] = RINGS.edgeRed[index];
+        rings.colour[1][index] = RINGS.edgeBlue[index];
+    }
+    for (int side = 0; side < 2; ++side) {
+        const Bitboard& stones = grid.getStones(side == 0 ? Player::RED : Player::BLUE);
+        for (int index = 0; index < HexGrid::CELL_COUNT; ++index) {
+            if (stones.test(index)) rings.place(index, side);
+        }
+    }
+
+    // Fill-in to a fixed point. Filling a cell only changes its neighbours'
+    // rings, so only those go back on the worklist.
+    uint8_t work[HexGrid::CELL_COUNT];
+    int workCount = 0;
+    Bitboard queued = empty;
+    for (int cell : grid.getEmptyCells()) work[workCount++] = (uint8_t)cell;
+
+    auto fill = [&](int cell, int side) {
+        rings.place(cell, side);
+        empty.reset(cell);
+        analysis.fill[side].set(cell);
+        for (int k = 0; k < 6; ++k) {
+            int n = RINGS.neighbor[cell][k];
+            if (n >= 0 && empty.test(n) && !queued.test(n)) {
+                queued.set(n);
+                work[workCount++] = (uint8_t)n;
+            }
+        }
+    };
+
+    while (workCount > 0) {
+        int cell = work[--workCount];
+        queued.reset(cell);
+        if (!empty.test(cell)) continue;
+        if (rings.dead(cell)) {
+            analysis.dead.set(cell);
+            fill(cell, 0);
+            continue;
+        }
+        // Captures need each cell of the pair to die from one more stone
+        if (!rings.oneShort(cell)) continue;
+        for (int k = 0; k < 6 && empty.test(cell); ++k) {
+            int other = RINGS.neighbor[cell][k];
+            if (other < 0 || !empty.test(other)) continue;
+            for (int side = 0; side < 2; ++side) {
+                if (rings.deadWith(cell, k, side) && rings.deadWith(other, (k + 3) % 6, side)) {
+                    analysis.captured[side].set(cell);
+                    analysis.captured[side].set(other);
+                    fill(cell, side);
+                    fill(other, side);
+                    break;
+                }
+            }
+        }
+    }
+
+    Bitboard red = grid.getStones(Player::RED) | analysis.fill[0];
+    Bitboard blue = grid.getStones(Player::BLUE) | analysis.fill[1];
+    if (PathFinding::connectsEdges(red, Player::RED)) analysis.filledWinner = Player::RED;
+    else if (PathFinding::connectsEdges(blue, Player::BLUE)) analysis.filledWinner = Player::BLUE;
+
+    // Domination for the side to move, on the filled board. A cell is only
+    // dropped while its killer is still in, so of two cells that kill each
+    // other the first one in empty-cell order goes and the other stays.
+    int side = grid.getCurrentPlayer() == Player::RED ? 0 : 1;
+    for (int cell : grid.getEmptyCells()) {
+        if (!empty.test(cell) || !rings.oneShort(cell)) continue;
+        for (int k = 0; k < 6; ++k) {
+            int killer = RINGS.neighbor[cell][k];
+            if (killer < 0 || !empty.test(killer) || analysis.dominated.test(killer)) continue;
+            if (rings.deadWith(cell, k, side)) {
+                analysis.dominated.set(cell);
+                break;
+            }
+        }
+    }
+
+    analysis.candidates = (analysis.filledWinner == Player::NONE)
+        ? empty & ~analysis.dominated
+        : HexGrid::ALL_CELLS & ~(grid.getStones(Player::RED) | grid.getStones(Player::BLUE));
+}
+
+std::vector<HexCoord> InferiorCells::candidateMoves(const HexGrid& grid) {
+    Analysis analysis;
+    analyze(grid, analysis);
+    return candidateMoves(grid, analysis);
+}
+
+std::vector<HexCoord> InferiorCells::candidateMoves(const HexGrid& grid, const Analysis& analysis) {
+    std::vector<HexCoord> moves;
+    moves.reserve(grid.getEmptyCount());
+    for (int index : grid.getEmptyCells()) {
+        if (analysis.candidates.test(index)) moves.push_back(HexGrid::fromIndex(index));
+    }
+    return moves;
+}
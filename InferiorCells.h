@@ -0,0 +1,35 @@
+#pragma once
+#include "HexGrid.h"
+#include <vector>
+
+// Inferior-cell analysis from the colours of each empty cell's six
+// neighbours (off-board neighbours take the colour of that edge):
+//   - dead: colouring the cell can never matter to either player. That is
+//     the case with 4 consecutive neighbours of one colour, or 3 consecutive
+//     of one colour with 2 consecutive of the other among the rest.
+//   - captured: an empty pair where either cell, taken by X, kills the
+//     other; X answers an intrusion in the pair, so both are X's already.
+//   - dominated: a cell killed by the side to move taking a neighbour (its
+//     killer). The killer is never a worse move, so the cell can go, as
+//     long as the killer itself stays a candidate.
+// Dead and captured cells are filled in and the patterns re-run until
+// nothing changes, since each fill can expose new ones.
+class InferiorCells {
+public:
+    struct Analysis {
+        Bitboard dead;
+        Bitboard captured[2];   // [0] = captured by RED, [1] = by BLUE
+        Bitboard dominated;     // for the side to move
+        Bitboard candidates;    // empty cells left worth playing
+        Bitboard fill[2];       // stones to pre-place for RED / BLUE (dead cells go to RED)
+        Player filledWinner;    // winner of the filled-in board, if already decided
+    };
+
+    static void analyze(const HexGrid& grid, Analysis& analysis);
+
+    // Candidate moves for the side to move, in empty-cell order. When the
+    // fill-in already decides the game nothing is pruned, so the search
+    // still finds (or delays) the actual finish.
+    static std::vector<HexCoord> candidateMoves(const HexGrid& grid);
+    static std::vector<HexCoord> candidateMoves(const HexGrid& grid, const Analysis& analysis);
+};
@@ -1,31 +1,169 @@
 #include "Minimax.h"
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <thread>
+
+// Search scores are fixed-point integers (evaluation x SCORE_SCALE), so
+// null-window tests are exact comparisons
+static const int SCORE_SCALE = 100;
+static const int WIN_SCORE = 1000000;
+static const int INFINITE_SCORE = WIN_SCORE + 1;
+static const int ASPIRATION_WINDOW = 25 * SCORE_SCALE;  // initial half-width around the last score
+
+// Plies (root = 0) that still get the full connectivity ordering; deeper
+// nodes order by TT move, killers and history
+static const int HEURISTIC_ORDER_PLIES = 2;
+
+// Leaf threat search: one attacking threat per line, a few dozen nodes at
+// most. A proven leaf gets a bonus on top of its evaluation, well below a
+// real win: the search still prefers a connection it can see, and among
+// proven lines (won or lost) the evaluation keeps choosing the best one.
+static const int LEAF_THREATS = 1;
+static const int LEAF_THREAT_NODES = 48;
+static const int THREAT_SCORE = WIN_SCORE / 2;
+
+Minimax::Minimax(size_t hashMegabytes)
+    : threadCount(1), evaluatorType(EvaluatorType::CONNECTIVITY), tt(hashMegabytes), scorer(std::make_shared<MoveScorer>()), hasDeadline(false), nodeBudget(0), stopSignal(nullptr), stopFlag(false) {}
+
+static int toScore(double evaluation) {
+    double scaled = std::round(evaluation * SCORE_SCALE);
+    return (int)std::max(-(double)(WIN_SCORE - 1), std::min((double)(WIN_SCORE - 1), scaled));
+}
+
+// Move the transposition-table move (if any) to the front of an ordered list
+static void promoteMove(std::vector<HexCoord>& moves, int cellIndex) {
+    if (cellIndex < 0) return;
+    HexCoord coord = HexGrid::fromIndex(cellIndex);
+    auto it = std::find(moves.begin(), moves.end(), coord);
+    if (it != moves.end()) {
+        std::rotate(moves.begin(), it, it + 1);
+    }
+}
 
 MinimaxResult Minimax::findBestMove(HexGrid& grid, int depth) {
-    nodesEvaluated = 0;
-    Player player = grid.getCurrentPlayer();
+    SearchLimits limits{depth, 0, 0};
+    return findBestMove(grid, limits);
+}
+
+MinimaxResult Minimax::findBestMove(HexGrid& grid, const SearchLimits& limits) {
+    return findBestMove(grid, limits, std::vector<HexCoord>());
+}
+
+MinimaxResult Minimax::findBestMove(HexGrid& grid, const SearchLimits& limits, const std::vector<HexCoord>& rootCandidates) {
+    stopFlag = false;
+    hasDeadline = limits.timeBudgetMs > 0;
+    nodeBudget = limits.nodeBudget;
+    stopSignal = limits.stopSignal;
+    auto startTime = std::chrono::steady_clock::now();
+    deadline = startTime + std::chrono::milliseconds(limits.timeBudgetMs);
+    tt.newSearch();
+    
+    std::vector<HexCoord> rootMoves = generateRootMoves(grid, rootCandidates);
+    
+    // Fallback if not even depth 1 completes: the best heuristic move
+    MinimaxResult best{Move(), 0.0, 0, 0, threadCount, 0.0};
+    if (!rootMoves.empty()) {
+        best.move = Move(rootMoves[0], grid.getCurrentPlayer());
+    }
     
-    std::vector<HexCoord> emptyCells;
-    for (const auto& kv : grid.getGrid()) {
-        if (kv.second == Player::NONE) {
-            emptyCells.push_back(kv.first);
+    // No depth limit means down to the last empty cell
+    int maxDepth = grid.getEmptyCount();
+    if (limits.maxDepth > 0) maxDepth = std::min(limits.maxDepth, maxDepth);
+    
+    // Helpers get their own board copies up front, before the main thread
+    // starts mutating the caller's grid
+    int helperCount = threadCount - 1;
+    std::vector<HexGrid> helperBoards(helperCount, grid);
+    std::vector<long long> helperNodes(helperCount, 0);
+    std::vector<std::thread> helpers;
+    for (int i = 0; i < helperCount; ++i) {
+        helpers.emplace_back([this, &helperBoards, &helperNodes, moves = rootMoves, maxDepth, i]() {
+            SearchWorker worker{helperBoards[i], 0, false, false, ResistanceEvaluator(), VirtualConnections(),
+                                MinimaxInternal::MoveHistory(), ThreatSearch(LEAF_THREATS, LEAF_THREAT_NODES)};
+            helperSearch(worker, moves, maxDepth, i + 1);
+            helperNodes[i] = worker.nodes;
+        });
+    }
+    
+    SearchWorker mainWorker{grid, 0, true, false, ResistanceEvaluator(), VirtualConnections(),
+                            MinimaxInternal::MoveHistory(), ThreatSearch(LEAF_THREATS, LEAF_THREAT_NODES)};
+    int score = 0;
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        MinimaxResult iteration;
+        if (!aspirationSearch(mainWorker, rootMoves, depth, score, iteration)) {
+            break;  // Out of budget - keep the last completed iteration
+        }
+        best = iteration;
+        
+        // Search the previous iteration's best move first next time
+        promoteMove(rootMoves, HexGrid::toIndex(best.move.coord));
+        
+        if (std::abs(score) >= WIN_SCORE) {
+            break;  // Forced result found, deeper search won't change it
         }
+        
+        // Each iteration costs several times the previous one; don't start
+        // one that has no realistic chance of finishing
+        if (hasDeadline) {
+            auto elapsed = std::chrono::steady_clock::now() - startTime;
+            if (elapsed * 2 > std::chrono::milliseconds(limits.timeBudgetMs)) break;
+        }
+    }
+    
+    stopFlag = true;
+    long long totalNodes = mainWorker.nodes;
+    for (int i = 0; i < helperCount; ++i) {
+        helpers[i].join();
+        totalNodes += helperNodes[i];
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    best.nodesEvaluated = (int)totalNodes;
+    best.threads = threadCount;
+    best.nodesPerSecond = seconds > 0.0 ? totalNodes / seconds : 0.0;
+    return best;
+}
+
+void Minimax::helperSearch(SearchWorker& worker, std::vector<HexCoord> rootMoves, int maxDepth, int helperId) {
+    // Odd helpers run one ply ahead of the main thread so that, between them,
+    // the threads fill the table for the next iteration as well as this one
+    int score = 0;
+    for (int depth = 1 + (helperId % 2); depth <= maxDepth; ++depth) {
+        MinimaxResult iteration;
+        if (!aspirationSearch(worker, rootMoves, depth, score, iteration)) {
+            break;
+        }
+        promoteMove(rootMoves, HexGrid::toIndex(iteration.move.coord));
+        if (std::abs(score) >= WIN_SCORE) {
+            break;
+        }
+    }
+}
+
+std::vector<HexCoord> Minimax::generateRootMoves(HexGrid& grid, const std::vector<HexCoord>& rootCandidates) {
+    Player player = grid.getCurrentPlayer();
+    
+    // Dead, captured and dominated cells never need searching
+    std::vector<HexCoord> emptyCells = InferiorCells::candidateMoves(grid);
+    if (!rootCandidates.empty()) {
+        emptyCells.erase(std::remove_if(emptyCells.begin(), emptyCells.end(), [&](const HexCoord& coord) {
+            return std::find(rootCandidates.begin(), rootCandidates.end(), coord) == rootCandidates.end();
+        }), emptyCells.end());
+        // The caller's list may hold cells the pruning dropped; keep it whole then
+        if (emptyCells.empty()) emptyCells = rootCandidates;
     }
     
     // Sort moves by heuristic score instead of random shuffle
-    emptyCells = orderMovesByHeuristic(grid, emptyCells, player);
+    emptyCells = scorer->orderMoves(grid, emptyCells, player);
     
-    Move bestMove;
-    double bestScore = -std::numeric_limits<double>::max();
-    double alpha = -std::numeric_limits<double>::max();
-    double beta = std::numeric_limits<double>::max();
+    TTEntry entry;
+    if (tt.probe(grid.getHash(), entry)) {
+        promoteMove(emptyCells, entry.move);
+    }
     
     // OPTIMIZED: Check fewer moves based on board state
-    int moveCount = 0;
-    for (const auto& kv : grid.getGrid()) {
-        if (kv.second != Player::NONE) moveCount++;
-    }
+    int moveCount = HexGrid::CELL_COUNT - grid.getEmptyCount();
     
     int movesToCheck;
     if (moveCount < 8) {
@@ -35,79 +173,211 @@ MinimaxResult Minimax::findBestMove(HexGrid& grid, int depth) {
     } else {
         movesToCheck = std::min(15, (int)emptyCells.size()); // Mid game: 15 moves
     }
-    for (int i = 0; i < movesToCheck; ++i) {
-        const HexCoord& coord = emptyCells[i];
+    emptyCells.resize(movesToCheck);
+    return emptyCells;
+}
+
+bool Minimax::aspirationSearch(SearchWorker& worker, const std::vector<HexCoord>& rootMoves, int depth,
+                               int& score, MinimaxResult& result) {
+    // The first iteration has nothing to centre a window on
+    int delta = ASPIRATION_WINDOW;
+    int alpha = depth > 1 ? std::max(-INFINITE_SCORE, score - delta) : -INFINITE_SCORE;
+    int beta = depth > 1 ? std::min(INFINITE_SCORE, score + delta) : INFINITE_SCORE;
+    
+    while (true) {
+        int found;
+        if (!searchRoot(worker, rootMoves, depth, alpha, beta, result, found)) return false;
         
-        grid.makeMove(coord);
-        double score = -minimaxAlphaBeta(grid, depth - 1, -beta, -alpha, player);
+        // Outside the window the score is only a bound: widen that side and retry
+        if (found <= alpha && alpha > -INFINITE_SCORE) {
+            alpha = std::max(-INFINITE_SCORE, found - delta);
+        } else if (found >= beta && beta < INFINITE_SCORE) {
+            beta = std::min(INFINITE_SCORE, found + delta);
+        } else {
+            score = found;
+            return true;
+        }
+        delta *= 4;
+    }
+}
+
+bool Minimax::searchRoot(SearchWorker& worker, const std::vector<HexCoord>& rootMoves, int depth,
+                         int alpha, int beta, MinimaxResult& result, int& score) {
+    HexGrid& grid = worker.grid;
+    Player player = grid.getCurrentPlayer();
+    if (rootMoves.empty()) return false;
+    
+    int alphaOrig = alpha;
+    Move bestMove(rootMoves[0], player);
+    int bestScore = -INFINITE_SCORE;
+    
+    for (size_t i = 0; i < rootMoves.size(); ++i) {
+        grid.makeMove(rootMoves[i]);
+        int value = searchChild(worker, depth, 0, alpha, beta, i == 0);
         grid.undoMove();
         
-        if (score > bestScore) {
-            bestScore = score;
-            bestMove = Move(coord, player);
+        if (worker.aborted) return false;
+        
+        if (value > bestScore) {
+            bestScore = value;
+            bestMove = Move(rootMoves[i], player);
         }
         
-        alpha = std::max(alpha, score);
+        alpha = std::max(alpha, value);
         if (alpha >= beta) break;
     }
     
-    return MinimaxResult{bestMove, bestScore, nodesEvaluated};
+    BoundType bound = BoundType::EXACT;
+    if (bestScore <= alphaOrig) bound = BoundType::UPPER;
+    else if (bestScore >= beta) bound = BoundType::LOWER;
+    tt.store(grid.getHash(), depth, bound, bestScore, HexGrid::toIndex(bestMove.coord));
+    
+    score = bestScore;
+    result = MinimaxResult{bestMove, (double)bestScore / SCORE_SCALE, (int)worker.nodes, depth, threadCount, 0.0};
+    return true;
+}
+
+int Minimax::searchChild(SearchWorker& worker, int depth, int ply, int alpha, int beta, bool firstMove) {
+    // Principal variation search: after the first move, only prove that a
+    // move is no better than alpha (null window); a move that fails high
+    // gets a full-window re-search for its exact score
+    if (firstMove) {
+        return -minimaxAlphaBeta(worker, depth - 1, ply + 1, -beta, -alpha);
+    }
+    int value = -minimaxAlphaBeta(worker, depth - 1, ply + 1, -alpha - 1, -alpha);
+    if (value > alpha && value < beta && !worker.aborted) {
+        value = -minimaxAlphaBeta(worker, depth - 1, ply + 1, -beta, -alpha);
+    }
+    return value;
 }
 
-double Minimax::minimaxAlphaBeta(HexGrid& grid, int depth, double alpha, double beta, Player originalPlayer) {
-    nodesEvaluated++;
+void Minimax::checkLimits(SearchWorker& worker) {
+    // Every node runs an evaluation or an inferior-cell pass, each about a
+    // microsecond, so checking the clock at every node costs little. The node budget is per
+    // thread, which keeps the counters private.
+    if (stopFlag.load(std::memory_order_relaxed)) {
+        worker.aborted = true;
+    } else if (stopSignal && stopSignal->load(std::memory_order_relaxed)) {
+        worker.aborted = true;
+    } else if (nodeBudget > 0 && worker.nodes >= nodeBudget) {
+        worker.aborted = true;
+    } else if (hasDeadline && std::chrono::steady_clock::now() >= deadline) {
+        worker.aborted = true;
+    }
     
-    Player winner = grid.getWinner();
-    if (winner == originalPlayer) return 10000.0;
-    if (winner != Player::NONE) return -10000.0;
+    if (worker.aborted && worker.isMain) {
+        stopFlag.store(true, std::memory_order_relaxed);
+    }
+}
+
+int Minimax::minimaxAlphaBeta(SearchWorker& worker, int depth, int ply, int alpha, int beta) {
+    HexGrid& grid = worker.grid;
+    worker.nodes++;
+    checkLimits(worker);
+    if (worker.aborted) return 0;
+    
+    // Someone has already connected: it can only be the player who just moved
+    if (grid.getWinner() != Player::NONE) return -WIN_SCORE;
+    
+    uint64_t key = grid.getHash();
+    int alphaOrig = alpha;
+    int ttMove = -1;
+    TTEntry entry;
+    if (tt.probe(key, entry)) {
+        ttMove = entry.move;
+        if (entry.depth >= depth) {
+            if (entry.bound == BoundType::EXACT) return entry.score;
+            if (entry.bound == BoundType::LOWER) alpha = std::max(alpha, entry.score);
+            else if (entry.bound == BoundType::UPPER) beta = std::min(beta, entry.score);
+            if (alpha >= beta) return entry.score;
+        }
+    }
     
     if (depth == 0) {
-        return evaluatePosition(grid, originalPlayer);
+        int score = toScore((evaluatorType == EvaluatorType::RESISTANCE)
+            ? worker.resistance.evaluate(grid, grid.getCurrentPlayer())
+            : evaluatePosition(worker, grid.getCurrentPlayer()));
+        score += threatScore(worker, grid.getCurrentPlayer());
+        tt.store(key, 0, BoundType::EXACT, score, -1);
+        return score;
     }
     
-    std::vector<HexCoord> emptyCells;
-    for (const auto& kv : grid.getGrid()) {
-        if (kv.second == Player::NONE) {
-            emptyCells.push_back(kv.first);
-        }
-    }
+    std::vector<HexCoord> emptyCells = InferiorCells::candidateMoves(grid);
     
-    if (emptyCells.empty()) return 0.0;
+    if (emptyCells.empty()) return 0;
     
-    // Sort moves by heuristic instead of random shuffle
     Player currentPlayer = grid.getCurrentPlayer();
-    emptyCells = orderMovesByHeuristic(grid, emptyCells, currentPlayer);
+    if (ply < HEURISTIC_ORDER_PLIES) {
+        emptyCells = scorer->orderMoves(grid, emptyCells, currentPlayer);
+        promoteMove(emptyCells, ttMove);
+    } else {
+        orderMovesByHistory(worker, emptyCells, ply, ttMove);
+    }
     
-    double maxScore = -std::numeric_limits<double>::max();
+    int maxScore = -INFINITE_SCORE;
+    int bestMove = -1;
     int movesToCheck = std::min(10, (int)emptyCells.size()); // Further reduced for speed
     
     for (int i = 0; i < movesToCheck; ++i) {
         grid.makeMove(emptyCells[i]);
-        double score = -minimaxAlphaBeta(grid, depth - 1, -beta, -alpha, originalPlayer);
+        int score = searchChild(worker, depth, ply, alpha, beta, i == 0);
         grid.undoMove();
         
-        maxScore = std::max(maxScore, score);
+        if (worker.aborted) return 0;  // Partial result - don't let it reach the table
+        
+        if (score > maxScore) {
+            maxScore = score;
+            bestMove = HexGrid::toIndex(emptyCells[i]);
+        }
         alpha = std::max(alpha, score);
-        if (alpha >= beta) break;
+        if (alpha >= beta) {
+            worker.ordering.recordCutoff(ply, bestMove, currentPlayer, depth);
+            break;
+        }
     }
     
+    BoundType bound = BoundType::EXACT;
+    if (maxScore <= alphaOrig) bound = BoundType::UPPER;
+    else if (maxScore >= beta) bound = BoundType::LOWER;
+    tt.store(key, depth, bound, maxScore, bestMove);
+    
     return maxScore;
 }
 
-double Minimax::evaluatePosition(const HexGrid& grid, Player player) {
+int Minimax::threatScore(SearchWorker& worker, Player player) {
     Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
     
-    double myConnectivity = PathFinding::calculateConnectivity(grid, player);
-    double oppConnectivity = PathFinding::calculateConnectivity(grid, opponent);
+    // VC distances never exceed the plain ones, so positions where the
+    // mover is more than one threat from connecting and the opponent has
+    // nothing to block can skip the search
+    if (worker.vc.analyze(worker.grid, player).distance > LEAF_THREATS + 1 &&
+        worker.vc.analyze(worker.grid, opponent).distance > 1) {
+        return 0;
+    }
     
-    int myBridges = PathFinding::countBridges(grid, player);
-    int oppBridges = PathFinding::countBridges(grid, opponent);
+    ThreatSearch::Outcome outcome = worker.threats.solve(worker.grid, player).outcome;
+    if (outcome == ThreatSearch::Outcome::WIN) return THREAT_SCORE;
+    if (outcome == ThreatSearch::Outcome::LOSS) return -THREAT_SCORE;
+    return 0;
+}
+
+double Minimax::evaluatePosition(SearchWorker& worker, Player player) {
+    const HexGrid& grid = worker.grid;
+    Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
     
-    int myStones = 0, oppStones = 0;
-    for (const auto& kv : grid.getGrid()) {
-        if (kv.second == player) myStones++;
-        else if (kv.second == opponent) oppStones++;
-    }
+    // Distances treat bridged groups and template-held stones as connected,
+    // so the leaves see links the search would otherwise have to play out
+    VirtualConnections::Summary mine = worker.vc.analyze(grid, player);
+    VirtualConnections::Summary theirs = worker.vc.analyze(grid, opponent);
+    
+    double myConnectivity = PathFinding::connectivityScore(mine.distance);
+    double oppConnectivity = PathFinding::connectivityScore(theirs.distance);
+    
+    int myBridges = mine.bridges + mine.edgeTemplates;
+    int oppBridges = theirs.bridges + theirs.edgeTemplates;
+    
+    int myStones = grid.getStoneCount(player);
+    int oppStones = grid.getStoneCount(opponent);
     
     // AGGRESSIVE DEFENSE: Opponent's progress is MORE important than our progress!
     double score = 0.0;
@@ -140,168 +410,34 @@ double Minimax::evaluatePosition(const HexGrid& grid, Player player) {
     return score;
 }
 
-double Minimax::scoreMoveHeuristic(HexGrid& grid, const HexCoord& move, Player player) {
-    Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
-    
-    double score = 0.0;
-    
-    // 1. Check immediate win/block
-    grid.makeMoveFor(move, player);
-    Player winner = grid.getWinner();
-    if (winner == player) {
-        grid.undoMove();
-        return 100000.0; // Winning move!
-    }
-    grid.undoMove();
-    
-    // 2. Calculate connectivity BEFORE the move
-    double myConnectivityBefore = PathFinding::calculateConnectivity(grid, player);
-    double oppConnectivityBefore = PathFinding::calculateConnectivity(grid, opponent);
-    
-    // 3. Make the move and calculate connectivity AFTER
-    grid.makeMoveFor(move, player);
-    double myConnectivityAfter = PathFinding::calculateConnectivity(grid, player);
-    double oppConnectivityAfter = PathFinding::calculateConnectivity(grid, opponent);
-    grid.undoMove();
-    
-    // 4. Calculate improvements/blocking
-    double myImprovement = myConnectivityAfter - myConnectivityBefore;
-    double oppReduction = oppConnectivityBefore - oppConnectivityAfter; // Positive = we blocked them
-    
-    // ULTRA-AGGRESSIVE DEFENSIVE WEIGHTING
-    double myWeight = 100.0;
-    double oppWeight = 200.0;  // Defense is TWICE as important by default!
-    
-    // If opponent is ahead, prioritize blocking MUCH MORE!
-    if (oppConnectivityBefore > myConnectivityBefore + 1.0) {
-        oppWeight = 400.0; // Super aggressive blocking when behind
-    }
-    
-    // If opponent is very close to winning, EMERGENCY BLOCKING!
-    if (oppConnectivityBefore > HexGrid::BOARD_SIZE * 1.4) {
-        oppWeight = 800.0; // CRITICAL blocking
-        score += oppReduction * 300.0; // Massive bonus for blocking
-    } else if (oppConnectivityBefore > HexGrid::BOARD_SIZE * 1.0) {
-        oppWeight = 500.0; // High priority blocking
-        score += oppReduction * 150.0;
-    }
+void Minimax::orderMovesByHistory(const SearchWorker& worker, std::vector<HexCoord>& moves, int ply, int ttMove) {
+    const MinimaxInternal::MoveHistory& ordering = worker.ordering;
+    const int* history = ordering.history[worker.grid.getCurrentPlayer() == Player::RED ? 0 : 1];
     
-    score += myImprovement * myWeight;
-    score += oppReduction * oppWeight;
-    
-    // 6. Check if this blocks an immediate opponent win
-    int oppNeighbors = 0;
-    std::vector<HexCoord> neighbors = grid.getNeighbors(move);
-    for (const HexCoord& n : neighbors) {
-        if (grid.getCell(n) == opponent) {
-            oppNeighbors++;
-        }
-    }
-    if (oppNeighbors >= 2) {
-        score += 3000.0; // Blocking a strong opponent connection
-    }
-    
-    // 7. Count friendly neighbors (encourage connection)
-    int friendlyNeighbors = 0;
-    for (const HexCoord& neighbor : neighbors) {
-        if (grid.getCell(neighbor) == player) {
-            friendlyNeighbors++;
-        }
-    }
-    score += friendlyNeighbors * 80.0;  // Bonus for connecting to our stones
-    
-    // 8. Strategic positioning - prefer center of the board
-    int centerQ = HexGrid::BOARD_SIZE / 2;
-    int centerR = HexGrid::BOARD_SIZE / 2;
-    int distToCenter = abs(move.q - centerQ) + abs(move.r - centerR);
-    score += (HexGrid::BOARD_SIZE - distToCenter) * 5.0;
-    
-    return score;
-}
-
-std::vector<HexCoord> Minimax::orderMovesByHeuristic(HexGrid& grid, const std::vector<HexCoord>& moves, Player player) {
     std::vector<MinimaxInternal::MoveScore> scoredMoves;
     scoredMoves.reserve(moves.size());
-    
-    Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
-    
-    // Calculate baseline connectivity ONCE
-    double myConnBefore = PathFinding::calculateConnectivity(grid, player);
-    double oppConnBefore = PathFinding::calculateConnectivity(grid, opponent);
-    
-    // Score EVERY move by actual connectivity impact (this is the TRUE heuristic!)
     for (const HexCoord& move : moves) {
-        // simulate move for the given player explicitly (safer)
-        grid.makeMoveFor(move, player);
-        
-        // Check immediate win first
-        if (grid.getWinner() == player) {
-            scoredMoves.push_back({move, 1000000.0});
-            grid.undoMove();
-            continue;
-        }
-        
-        // Calculate connectivity after this move
-        double myConnAfter = PathFinding::calculateConnectivity(grid, player);
-        double oppConnAfter = PathFinding::calculateConnectivity(grid, opponent);
-        
-        grid.undoMove();
-        
-        // Calculate the ACTUAL impact of this move
-        double myGain = myConnAfter - myConnBefore;
-        double oppLoss = oppConnBefore - oppConnAfter;  // Positive if we hurt opponent
-        
-        // Adaptive weights based on game state
-        double offenseWeight = 1.0;
-        double defenseWeight = 1.5;  // Slightly favor defense by default
-        
-        // ULTRA-AGGRESSIVE Dynamic strategy adjustment
-        if (oppConnBefore > myConnBefore + 2.0) {
-            // We're behind - MUST block aggressively
-            defenseWeight = 5.0;
-            offenseWeight = 0.3;
-        } else if (oppConnBefore > myConnBefore + 1.0) {
-            // Opponent slightly ahead - heavy defense
-            defenseWeight = 3.5;
-            offenseWeight = 0.6;
-        } else if (myConnBefore > oppConnBefore + 3.0) {
-            // We're well ahead - can focus on winning
-            offenseWeight = 2.5;
-            defenseWeight = 1.0;
-        } else if (oppConnBefore > HexGrid::BOARD_SIZE * 1.5) {
-            // Opponent VERY close to winning - EMERGENCY blocking!
-            defenseWeight = 8.0;
-            offenseWeight = 0.1;
-        } else if (oppConnBefore > HexGrid::BOARD_SIZE * 1.2) {
-            // Opponent close to winning - critical blocking!
-            defenseWeight = 6.0;
-            offenseWeight = 0.2;
-        }
-        
-        // Final score is weighted sum of offense and defense
-        double score = (myGain * offenseWeight) + (oppLoss * defenseWeight);
-        
-        // Small bonus for connecting to existing stones (tie-breaker)
-        int friendlyNeighbors = 0;
-        std::vector<HexCoord> neighbors = grid.getNeighbors(move);
-        for (const HexCoord& n : neighbors) {
-            if (grid.getCell(n) == player) {
-                friendlyNeighbors++;
+        int index = HexGrid::toIndex(move);
+        double score;
+        if (index == ttMove) {
+            score = 3e9;
+        } else if (index == ordering.killers[ply][0]) {
+            score = 2e9;
+        } else if (index == ordering.killers[ply][1]) {
+            score = 1e9;
+        } else {
+            // History first; cells touching stones break ties among the rest
+            int stonesAround = 0;
+            for (int n : HexGrid::getNeighborIndices(index)) {
+                if (worker.grid.getCell(n) != Player::NONE) stonesAround++;
             }
+            score = history[index] * 8.0 + stonesAround;
         }
-        score += friendlyNeighbors * 0.5;
-        
         scoredMoves.push_back({move, score});
     }
     
-    // Sort by score (highest first)
-    std::sort(scoredMoves.begin(), scoredMoves.end());
-    
-    std::vector<HexCoord> orderedMoves;
-    orderedMoves.reserve(moves.size());
-    for (const MinimaxInternal::MoveScore& ms : scoredMoves) {
-        orderedMoves.push_back(ms.coord);
+    std::stable_sort(scoredMoves.begin(), scoredMoves.end());
+    for (size_t i = 0; i < moves.size(); ++i) {
+        moves[i] = scoredMoves[i].coord;
     }
-    
-    return orderedMoves;
 }
@@ -1,14 +1,41 @@
 #pragma once
 #include "HexGrid.h"
+#include "InferiorCells.h"
+#include "MoveScorer.h"
 #include "PathFinding.h"
+#include "TranspositionTable.h"
+#include "ResistanceEvaluator.h"
+#include "ThreatSearch.h"
+#include "VirtualConnections.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <vector>
 
 struct MinimaxResult {
     Move move;
-    double score;
+    double score;       // in evaluation units, from the mover's point of view
     int nodesEvaluated;
+    int depthReached;   // deepest fully completed iteration
+    int threads;        // search threads used (1 = single-threaded)
+    double nodesPerSecond;
+};
+
+// Budget for an iterative-deepening search; 0 means "no limit"
+struct SearchLimits {
+    int maxDepth;
+    int timeBudgetMs;
+    long long nodeBudget;
+    const std::atomic<bool>* stopSignal = nullptr;  // set from another thread to end the search early
+};
+
+// Leaf evaluation used by the search
+enum class EvaluatorType {
+    CONNECTIVITY,   // VC-aware shortest-path distances, bridges and stone counts (default)
+    RESISTANCE      // edge-to-edge resistance of each player's network
 };
 
 namespace MinimaxInternal {
@@ -20,17 +47,107 @@ namespace MinimaxInternal {
             return score > other.score; // Higher scores first
         }
     };
+    
+    // Killer moves (two per ply) and a history table per player and cell,
+    // both fed by beta cutoffs. Cheap ordering for the plies below the ones
+    // that get the full connectivity ordering.
+    struct MoveHistory {
+        static const int MAX_PLY = HexGrid::CELL_COUNT + 1;
+        
+        int killers[MAX_PLY][2];   // cell index, -1 = none
+        int history[2][HexGrid::CELL_COUNT];
+        
+        MoveHistory() {
+            for (auto& slot : killers) slot[0] = slot[1] = -1;
+            for (auto& row : history) std::fill(std::begin(row), std::end(row), 0);
+        }
+        
+        void recordCutoff(int ply, int cell, Player player, int depth) {
+            if (killers[ply][0] != cell) {
+                killers[ply][1] = killers[ply][0];
+                killers[ply][0] = cell;
+            }
+            history[player == Player::RED ? 0 : 1][cell] += depth * depth;
+        }
+    };
+    
+    // Per-thread search state. Every thread keeps its worker on its own stack,
+    // so the node counter is a plain integer that no other thread touches.
+    struct SearchWorker {
+        HexGrid& grid;      // this thread's private board
+        long long nodes;
+        bool isMain;
+        bool aborted;
+        ResistanceEvaluator resistance;  // warm-start state is per thread
+        VirtualConnections vc;           // so is the VC summary cache
+        MoveHistory ordering;            // killers and history, kept across iterations
+        ThreatSearch threats;            // forcing-line check at the leaves
+    };
 }
 
 class Minimax {
 public:
+    explicit Minimax(size_t hashMegabytes = 16);
+    
+    // Fixed-depth search
     MinimaxResult findBestMove(HexGrid& grid, int depth);
     
+    // Iterative deepening: searches depth 1, 2, ... until a limit is hit and
+    // returns the best move of the last iteration that completed
+    MinimaxResult findBestMove(HexGrid& grid, const SearchLimits& limits);
+    
+    // Same, with the root restricted to `rootCandidates` (e.g. the defences
+    // against a threat); an empty list means no restriction
+    MinimaxResult findBestMove(HexGrid& grid, const SearchLimits& limits, const std::vector<HexCoord>& rootCandidates);
+    
+    // The transposition table persists across findBestMove calls; clear it
+    // when a new game starts
+    void setHashSize(size_t megabytes) { tt.resize(megabytes); }
+    void clearHash() { tt.clear(); }
+    
+    // Lazy SMP: with N > 1 threads, N - 1 helpers search their own board
+    // copies at staggered depths and share work only through the table
+    void setThreads(int threads) { threadCount = std::max(1, threads); }
+    int getThreads() const { return threadCount; }
+    
+    // Scores from different evaluators don't mix, so switching clears the table
+    void setEvaluator(EvaluatorType type) {
+        if (type != evaluatorType) tt.clear();
+        evaluatorType = type;
+    }
+    EvaluatorType getEvaluator() const { return evaluatorType; }
+    
+    // Root and near-root ordering goes through this scorer; share one with
+    // other engines so each position is scored once
+    void setMoveScorer(std::shared_ptr<MoveScorer> moveScorer) { scorer = std::move(moveScorer); }
+    
 private:
-    int nodesEvaluated;
+    typedef MinimaxInternal::SearchWorker SearchWorker;
+    
+    int threadCount;
+    EvaluatorType evaluatorType;
+    TranspositionTable tt;
+    std::shared_ptr<MoveScorer> scorer;
+    
+    // Limits of the search in progress
+    std::chrono::steady_clock::time_point deadline;
+    bool hasDeadline;
+    long long nodeBudget;
+    const std::atomic<bool>* stopSignal;
+    std::atomic<bool> stopFlag;
+    
+    std::vector<HexCoord> generateRootMoves(HexGrid& grid, const std::vector<HexCoord>& rootCandidates);
+    void helperSearch(SearchWorker& worker, std::vector<HexCoord> rootMoves, int maxDepth, int helperId);
+    bool aspirationSearch(SearchWorker& worker, const std::vector<HexCoord>& rootMoves, int depth,
+                          int& score, MinimaxResult& result);
+    bool searchRoot(SearchWorker& worker, const std::vector<HexCoord>& rootMoves, int depth,
+                    int alpha, int beta, MinimaxResult& result, int& score);
+    void checkLimits(SearchWorker& worker);
     
-    double minimaxAlphaBeta(HexGrid& grid, int depth, double alpha, double beta, Player originalPlayer);
-    double evaluatePosition(const HexGrid& grid, Player player);
-    double scoreMoveHeuristic(HexGrid& grid, const HexCoord& move, Player player);
-    std::vector<HexCoord> orderMovesByHeuristic(HexGrid& grid, const std::vector<HexCoord>& moves, Player player);
+    // Negamax: scores are fixed-point, from the point of view of the side to move
+    int minimaxAlphaBeta(SearchWorker& worker, int depth, int ply, int alpha, int beta);
+    int searchChild(SearchWorker& worker, int depth, int ply, int alpha, int beta, bool firstMove);
+    double evaluatePosition(SearchWorker& worker, Player player);
+    int threatScore(SearchWorker& worker, Player player);
+    void orderMovesByHistory(const SearchWorker& worker, std::vector<HexCoord>& moves, int ply, int ttMove);
 };
@@ -1,259 +1,345 @@
 #include "MonteCarlo.h"
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
 
-MonteCarloResult MonteCarlo::findBestMove(HexGrid& grid, int simulations) {
+const int MonteCarlo::TREE_CAPACITY;
+const int MonteCarlo::FLAT_ROUND;
+
+static const double UCT_EXPLORATION = 0.7;
+
+MonteCarlo::MonteCarlo() : threadCount(1), scorer(std::make_shared<MoveScorer>()), arenaUsed(0) {}
+
+MonteCarloResult MonteCarlo::findBestMove(HexGrid& grid, int maxSimulations, int timeBudgetMs) {
+    auto startTime = std::chrono::steady_clock::now();
+    if (maxSimulations <= 0 && timeBudgetMs <= 0) timeBudgetMs = 1;  // never unbounded
+    bool hasDeadline = timeBudgetMs > 0;
+    TimePoint deadline = startTime + std::chrono::milliseconds(timeBudgetMs);
     std::random_device rd;
-    rng.seed(rd());
     
     Player player = grid.getCurrentPlayer();
     
-    std::vector<HexCoord> emptyCells;
-    for (const auto& kv : grid.getGrid()) {
-        if (kv.second == Player::NONE) {
-            emptyCells.push_back(kv.first);
-        }
-    }
+    // Inferior cells are dropped from the candidates, and dead and captured
+    // ones are pre-filled in every playout
+    InferiorCells::Analysis analysis;
+    InferiorCells::analyze(grid, analysis);
+    std::vector<HexCoord> emptyCells = InferiorCells::candidateMoves(grid, analysis);
     
     if (emptyCells.empty()) {
-        return MonteCarloResult{Move(), 0.0, 0};
+        return MonteCarloResult{Move(), 0.0, 0, 0, threadCount, 0.0};
     }
     
     // Sort moves by heuristic instead of random shuffle
-    emptyCells = orderMovesByHeuristic(grid, emptyCells, player);
+    emptyCells = scorer->orderMoves(grid, emptyCells, player);
     
     int movesToTry = std::min(8, (int)emptyCells.size()); // Further reduced for speed
+    
+    // Root parallelism: each thread plays rounds of FLAT_ROUND playouts per
+    // candidate on its own board copy with its own RNG, up to its share of
+    // maxSimulations; counts merge at the end
+    std::vector<std::vector<int>> threadWins(threadCount, std::vector<int>(movesToTry, 0));
+    std::vector<int> threadSims(threadCount, 0);   // playouts per move
+    std::vector<uint32_t> seeds(threadCount);
+    for (uint32_t& seed : seeds) seed = rd();
+    
+    auto runShare = [&](HexGrid& board, int t) {
+        std::mt19937 rng(seeds[t]);
+        int share = maxSimulations > 0 ? (maxSimulations + threadCount - 1 - t) / threadCount : 0;
+        while (maxSimulations <= 0 || threadSims[t] < share) {
+            int round = maxSimulations > 0 ? std::min(FLAT_ROUND, share - threadSims[t]) : FLAT_ROUND;
+            for (int i = 0; i < movesToTry; ++i) {
+                board.makeMove(emptyCells[i]);
+                for (int sim = 0; sim < round; ++sim) {
+                    if (simulatePlayout(board, rng, analysis.fill) == player) {
+                        threadWins[t][i]++;
+                    }
+                }
+                board.undoMove();
+            }
+            threadSims[t] += round;
+            if (hasDeadline && std::chrono::steady_clock::now() >= deadline) break;
+        }
+    };
+    
+    std::vector<HexGrid> boards(threadCount - 1, grid);
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threadCount; ++t) {
+        workers.emplace_back([&runShare, &boards, t]() { runShare(boards[t - 1], t); });
+    }
+    runShare(grid, 0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    
+    int simulations = 0;
+    for (int t = 0; t < threadCount; ++t) {
+        simulations += threadSims[t];
+    }
+    
     Move bestMove;
     double bestWinRate = -1.0;
     int totalSimulations = 0;
     
     for (int i = 0; i < movesToTry; ++i) {
-        const HexCoord& coord = emptyCells[i];
         int wins = 0;
-        
-        for (int sim = 0; sim < simulations; ++sim) {
-            grid.makeMove(coord);
-            Player result = simulatePlayout(grid, player);
-            grid.undoMove();
-            
-            if (result == player) {
-                wins++;
-            }
+        for (int t = 0; t < threadCount; ++t) {
+            wins += threadWins[t][i];
         }
         
-        double winRate = (double)wins / simulations;
+        double winRate = simulations > 0 ? (double)wins / simulations : 0.0;
         totalSimulations += simulations;
         
         if (winRate > bestWinRate) {
             bestWinRate = winRate;
-            bestMove = Move(coord, player);
+            bestMove = Move(emptyCells[i], player);
         }
     }
     
-    return MonteCarloResult{bestMove, bestWinRate, totalSimulations};
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    double rate = seconds > 0.0 ? totalSimulations / seconds : 0.0;
+    return MonteCarloResult{bestMove, bestWinRate, totalSimulations, 0, threadCount, rate};
 }
 
-Player MonteCarlo::simulatePlayout(HexGrid& grid, Player originalPlayer) {
-    const int MAX_MOVES = 50;  // Reduced from 200
-    int movesMade = 0;
+MonteCarloResult MonteCarlo::findBestMoveUCT(HexGrid& grid, int maxPlayouts, int timeBudgetMs) {
+    auto startTime = std::chrono::steady_clock::now();
+    if (maxPlayouts <= 0 && timeBudgetMs <= 0) timeBudgetMs = 1;  // never unbounded
+    std::random_device rd;
     
-    std::vector<HexCoord> emptyCells;
+    if (!arena) {
+        arena.reset(new TreeNode[TREE_CAPACITY]);  // one allocation for the lifetime of this object
+    }
+    arenaUsed = 0;
     
-    Player winner = Player::NONE;
+    Player player = grid.getCurrentPlayer();
     
-    // Check for winner every 3 moves instead of every move
-    while (movesMade < MAX_MOVES) {
-        if (movesMade % 3 == 0) {  // Only check winner every 3 moves
-            winner = grid.getWinner();
-            if (winner != Player::NONE) break;
-        }
-        
-        emptyCells.clear();
-        for (const auto& kv : grid.getGrid()) {
-            if (kv.second == Player::NONE) {
-                emptyCells.push_back(kv.first);
-            }
-        }
-        
-        if (emptyCells.empty()) {
-            winner = grid.getWinner();  // Final check
-            break;
-        }
-        
-        std::uniform_int_distribution<int> dist(0, emptyCells.size() - 1);
-        HexCoord randomCoord = emptyCells[dist(rng)];
-        
-        grid.makeMove(randomCoord);
-        movesMade++;
+    InferiorCells::Analysis analysis;
+    InferiorCells::analyze(grid, analysis);
+    playoutFill[0] = analysis.fill[0];
+    playoutFill[1] = analysis.fill[1];
+    
+    int root = arenaUsed++;
+    arena[root].init(0);
+    if (!expandNode(grid, root, true)) {
+        return MonteCarloResult{Move(), 0.0, 0, arenaUsed, threadCount, 0.0};
     }
     
-    // Final winner check if we exited due to MAX_MOVES
-    if (winner == Player::NONE) {
-        winner = grid.getWinner();
+    bool hasDeadline = timeBudgetMs > 0;
+    TimePoint deadline = startTime + std::chrono::milliseconds(timeBudgetMs);
+    
+    // Tree parallelism: every thread walks the shared tree on its own board copy
+    std::vector<HexGrid> boards(threadCount - 1, grid);
+    std::vector<int> playouts(threadCount, 0);
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threadCount; ++t) {
+        // Split a playout budget evenly; the shares sum to exactly maxPlayouts
+        int share = maxPlayouts > 0 ? (maxPlayouts + t) / threadCount : 0;
+        if (maxPlayouts > 0 && share == 0) continue;
+        uint32_t seed = rd();
+        workers.emplace_back([this, &boards, &playouts, root, share, hasDeadline, deadline, seed, t]() {
+            treeWorker(boards[t - 1], root, share, hasDeadline, deadline, seed, playouts[t]);
+        });
+    }
+    int mainShare = maxPlayouts > 0 ? maxPlayouts / threadCount : 0;
+    if (maxPlayouts <= 0 || mainShare > 0) {
+        treeWorker(grid, root, mainShare, hasDeadline, deadline, rd(), playouts[0]);
     }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    
+    int totalPlayouts = 0;
+    for (int count : playouts) totalPlayouts += count;
     
-    // Undo all moves
-    for (int i = 0; i < movesMade; ++i) {
-        grid.undoMove();
+    // Most-visited root child is the most robust choice
+    const TreeNode& rootNode = arena[root];
+    int first = rootNode.firstChild.load();
+    int best = first;
+    for (int c = first; c < first + rootNode.childCount; ++c) {
+        if (arena[c].visits.load() > arena[best].visits.load()) best = c;
     }
     
-    return winner;
+    int visits = arena[best].visits.load();
+    double winRate = visits > 0 ? (double)arena[best].wins.load() / visits : 0.0;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    double rate = seconds > 0.0 ? totalPlayouts / seconds : 0.0;
+    int nodes = std::min((int)arenaUsed, TREE_CAPACITY);
+    return MonteCarloResult{Move(HexGrid::fromIndex(arena[best].move), player), winRate, totalPlayouts, nodes, threadCount, rate};
 }
 
-double MonteCarlo::scoreMoveHeuristic(HexGrid& grid, const HexCoord& move, Player player) {
+void MonteCarlo::treeWorker(HexGrid& grid, int root, int maxPlayouts, bool hasDeadline, TimePoint deadline,
+                            uint32_t seed, int& playouts) {
+    std::mt19937 rng(seed);
+    Player player = grid.getCurrentPlayer();
     Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
     
-    double score = 0.0;
+    // Virtual loss only matters when other threads share the tree
+    int virtualLoss = threadCount > 1 ? VIRTUAL_LOSS : 0;
+    int path[HexGrid::CELL_COUNT + 1];
+    int count = 0;
     
-    // 1. Check immediate win/block
-    grid.makeMoveFor(move, player);
-    Player winner = grid.getWinner();
-    if (winner == player) {
-        grid.undoMove();
-        return 100000.0; // Winning move!
+    while (maxPlayouts <= 0 || count < maxPlayouts) {
+        if (hasDeadline && (count & 63) == 0 && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        
+        // 1. Selection: descend by UCT through expanded nodes, marking each
+        // chosen child with a virtual loss so other threads look elsewhere
+        int depth = 0;
+        int node = root;
+        path[depth++] = node;
+        int first = arena[node].firstChild.load(std::memory_order_acquire);
+        while (first >= 0 && grid.getWinner() == Player::NONE) {
+            node = selectChild(arena[node], first);
+            arena[node].visits.fetch_add(virtualLoss, std::memory_order_relaxed);
+            grid.makeMove(HexGrid::fromIndex(arena[node].move));
+            path[depth++] = node;
+            first = arena[node].firstChild.load(std::memory_order_acquire);
+        }
+        
+        // 2. Expansion: grow the tree by one level once a leaf has been visited
+        Player winner = grid.getWinner();
+        if (winner == Player::NONE && arena[node].visits.load(std::memory_order_relaxed) >= EXPAND_THRESHOLD &&
+            expandNode(grid, node, false)) {
+            node = selectChild(arena[node], arena[node].firstChild.load(std::memory_order_relaxed));
+            arena[node].visits.fetch_add(virtualLoss, std::memory_order_relaxed);
+            grid.makeMove(HexGrid::fromIndex(arena[node].move));
+            path[depth++] = node;
+            winner = grid.getWinner();
+        }
+        
+        // 3. Simulation
+        if (winner == Player::NONE) {
+            winner = simulatePlayout(grid, rng, playoutFill);
+        }
+        
+        // 4. Backpropagation: path[i] was reached by a move of the root player
+        // when i is odd, of the opponent when i is even
+        for (int i = 0; i < depth; ++i) {
+            TreeNode& n = arena[path[i]];
+            Player mover = (i % 2 == 1) ? player : opponent;
+            n.visits.fetch_add(i == 0 ? 1 : 1 - virtualLoss, std::memory_order_relaxed);
+            if (winner == mover) n.wins.fetch_add(1, std::memory_order_relaxed);
+        }
+        for (int i = 1; i < depth; ++i) {
+            grid.undoMove();
+        }
+        count++;
     }
-    grid.undoMove();
     
-    // 2. Calculate connectivity BEFORE the move
-    double myConnectivityBefore = PathFinding::calculateConnectivity(grid, player);
-    double oppConnectivityBefore = PathFinding::calculateConnectivity(grid, opponent);
-    
-    // 3. Make the move and calculate connectivity AFTER
-    grid.makeMoveFor(move, player);
-    double myConnectivityAfter = PathFinding::calculateConnectivity(grid, player);
-    double oppConnectivityAfter = PathFinding::calculateConnectivity(grid, opponent);
-    grid.undoMove();
-    
-    // 4. Calculate improvements/blocking
-    double myImprovement = myConnectivityAfter - myConnectivityBefore;
-    double oppReduction = oppConnectivityBefore - oppConnectivityAfter; // Positive = we blocked them
-    
-    // 5. ULTRA-AGGRESSIVE weighting based on game state
-    double myWeight = 100.0;
-    double oppWeight = 200.0;  // Defense MORE important by default!
-    
-    // If opponent is ahead, prioritize blocking MUCH MORE!
-    if (oppConnectivityBefore > myConnectivityBefore + 1.0) {
-        oppWeight = 400.0; // Super aggressive blocking when behind
-    }
+    playouts = count;
+}
+
+bool MonteCarlo::expandNode(HexGrid& grid, int nodeIndex, bool heuristicOrder) {
+    TreeNode& node = arena[nodeIndex];
     
-    // If opponent is very close to winning, EMERGENCY BLOCKING!
-    if (oppConnectivityBefore > HexGrid::BOARD_SIZE * 1.4) {
-        oppWeight = 800.0; // CRITICAL blocking
-        score += oppReduction * 300.0; // Massive bonus for blocking
-    } else if (oppConnectivityBefore > HexGrid::BOARD_SIZE * 1.0) {
-        oppWeight = 500.0; // High priority blocking
-        score += oppReduction * 150.0;
+    // Claim the node; if another thread got there first, keep treating it as a leaf
+    int expected = TreeNode::UNEXPANDED;
+    if (!node.firstChild.compare_exchange_strong(expected, TreeNode::EXPANDING)) {
+        return false;
     }
     
-    score += myImprovement * myWeight;
-    score += oppReduction * oppWeight;
-    
-    // 6. Check if this blocks an immediate opponent win
-    int oppNeighbors = 0;
-    std::vector<HexCoord> neighbors = grid.getNeighbors(move);
-    for (const HexCoord& n : neighbors) {
-        if (grid.getCell(n) == opponent) {
-            oppNeighbors++;
-        }
+    // Children only for cells that survive inferior-cell pruning
+    InferiorCells::Analysis analysis;
+    InferiorCells::analyze(grid, analysis);
+    int childCount = analysis.candidates.count();
+    if (childCount == 0 || arenaUsed.load(std::memory_order_relaxed) + childCount > TREE_CAPACITY) {
+        node.firstChild.store(TreeNode::EXHAUSTED, std::memory_order_relaxed);
+        return false;
     }
-    if (oppNeighbors >= 2) {
-        score += 3000.0; // Blocking a strong opponent connection
+    int first = arenaUsed.fetch_add(childCount);
+    if (first + childCount > TREE_CAPACITY) {
+        node.firstChild.store(TreeNode::EXHAUSTED, std::memory_order_relaxed);
+        return false;
     }
     
-    // 7. Count friendly neighbors (encourage connection)
-    int friendlyNeighbors = 0;
-    for (const HexCoord& neighbor : neighbors) {
-        if (grid.getCell(neighbor) == player) {
-            friendlyNeighbors++;
+    if (heuristicOrder) {
+        // Root only (once per search): unvisited children are tried in array
+        // order, so this puts the first playouts on the most promising moves
+        std::vector<HexCoord> moves = InferiorCells::candidateMoves(grid, analysis);
+        moves = scorer->orderMoves(grid, moves, grid.getCurrentPlayer());
+        for (int i = 0; i < childCount; ++i) {
+            arena[first + i].init(HexGrid::toIndex(moves[i]));
+        }
+    } else {
+        // Write children straight into the arena - no per-node allocation
+        int child = first;
+        for (int index : grid.getEmptyCells()) {
+            if (analysis.candidates.test(index)) arena[child++].init(index);
         }
     }
-    score += friendlyNeighbors * 80.0;  // Bonus for connecting to our stones
     
-    // 8. Strategic positioning - prefer center of the board
-    int centerQ = HexGrid::BOARD_SIZE / 2;
-    int centerR = HexGrid::BOARD_SIZE / 2;
-    int distToCenter = abs(move.q - centerQ) + abs(move.r - centerR);
-    score += (HexGrid::BOARD_SIZE - distToCenter) * 5.0;
-    
-    return score;
+    // Publish: children and count become visible together with firstChild
+    node.childCount = (uint8_t)childCount;
+    node.firstChild.store(first, std::memory_order_release);
+    return true;
 }
 
-std::vector<HexCoord> MonteCarlo::orderMovesByHeuristic(HexGrid& grid, const std::vector<HexCoord>& moves, Player player) {
-    std::vector<MonteCarloInternal::MoveScore> scoredMoves;
-    scoredMoves.reserve(moves.size());
-    
-    Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
-    
-    // Calculate baseline connectivity ONCE
-    double myConnBefore = PathFinding::calculateConnectivity(grid, player);
-    double oppConnBefore = PathFinding::calculateConnectivity(grid, opponent);
-    
-    // Score EVERY move by actual connectivity impact
-    for (const HexCoord& move : moves) {
-        // score as if 'player' played the move
-        grid.makeMoveFor(move, player);
-        
-        // Check immediate win
-        if (grid.getWinner() == player) {
-            scoredMoves.push_back({move, 1000000.0});
-            grid.undoMove();
-            continue;
-        }
-        
-        // Calculate connectivity after move
-        double myConnAfter = PathFinding::calculateConnectivity(grid, player);
-        double oppConnAfter = PathFinding::calculateConnectivity(grid, opponent);
-        
-        grid.undoMove();
-        
-        // Calculate impact
-        double myGain = myConnAfter - myConnBefore;
-        double oppLoss = oppConnBefore - oppConnAfter;
-        
-        // ULTRA-AGGRESSIVE Adaptive weights (matching Minimax)
-        double offenseWeight = 1.0;
-        double defenseWeight = 2.0;  // Default: defense is MORE important
-        
-        if (oppConnBefore > myConnBefore + 2.0) {
-            defenseWeight = 5.0;
-            offenseWeight = 0.3;
-        } else if (oppConnBefore > myConnBefore + 1.0) {
-            defenseWeight = 3.5;
-            offenseWeight = 0.6;
-        } else if (myConnBefore > oppConnBefore + 3.0) {
-            offenseWeight = 2.5;
-            defenseWeight = 1.0;
-        } else if (oppConnBefore > HexGrid::BOARD_SIZE * 1.5) {
-            defenseWeight = 8.0;
-            offenseWeight = 0.1;
-        } else if (oppConnBefore > HexGrid::BOARD_SIZE * 1.2) {
-            defenseWeight = 6.0;
-            offenseWeight = 0.2;
+int MonteCarlo::selectChild(const TreeNode& parent, int firstChild) const {
+    double logParent = std::log((double)std::max(1, parent.visits.load(std::memory_order_relaxed)));
+    int best = firstChild;
+    double bestValue = -1.0;
+    
+    for (int c = firstChild; c < firstChild + parent.childCount; ++c) {
+        const TreeNode& child = arena[c];
+        int visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            return c;  // Try every child once before trusting the statistics
         }
-        
-        double score = (myGain * offenseWeight) + (oppLoss * defenseWeight);
-        
-        // Tie-breaker
-        int friendlyNeighbors = 0;
-        std::vector<HexCoord> neighbors = grid.getNeighbors(move);
-        for (const HexCoord& n : neighbors) {
-            if (grid.getCell(n) == player) {
-                friendlyNeighbors++;
-            }
+        double value = (double)child.wins.load(std::memory_order_relaxed) / visits
+                     + UCT_EXPLORATION * std::sqrt(logParent / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = c;
         }
-        score += friendlyNeighbors * 0.5;
-        
-        scoredMoves.push_back({move, score});
+    }
+    return best;
+}
+
+Player MonteCarlo::simulatePlayout(const HexGrid& grid, std::mt19937& rng) {
+    // A full Hex board always has exactly one winner, so instead of playing
+    // random moves one at a time we hand out every empty cell at once and
+    // check connectivity a single time on a private copy of RED's stones.
+    uint8_t emptyCells[HexGrid::CELL_COUNT];
+    int emptyCount = grid.getEmptyCount();
+    std::memcpy(emptyCells, grid.getEmptyCells().begin(), emptyCount);
+    
+    Bitboard red = grid.getStones(Player::RED);
+    return dealCells(red, emptyCells, emptyCount, grid.getCurrentPlayer() == Player::RED, rng);
+}
+
+Player MonteCarlo::simulatePlayout(const HexGrid& grid, std::mt19937& rng, const Bitboard fill[2]) {
+    // Pre-filled cells keep their owner; only the rest are dealt at random.
+    // Cells taken since the fill was computed are left to their stones.
+    Bitboard filled = fill[0] | fill[1];
+    uint8_t emptyCells[HexGrid::CELL_COUNT];
+    int emptyCount = 0;
+    for (int cell : grid.getEmptyCells()) {
+        if (!filled.test(cell)) emptyCells[emptyCount++] = (uint8_t)cell;
     }
     
-    std::sort(scoredMoves.begin(), scoredMoves.end());
+    Bitboard red = grid.getStones(Player::RED) | (fill[0] & ~grid.getStones(Player::BLUE));
+    return dealCells(red, emptyCells, emptyCount, grid.getCurrentPlayer() == Player::RED, rng);
+}
+
+Player MonteCarlo::dealCells(Bitboard& red, uint8_t* emptyCells, int emptyCount, bool redToMove, std::mt19937& rng) {
+    // Partial Fisher-Yates: the side to move gets ceil(n/2) random cells,
+    // exactly what alternating random moves would give it
+    int moverCells = (emptyCount + 1) / 2;
+    for (int i = 0; i < moverCells; ++i) {
+        // Multiply-shift range reduction (Lemire): one 32-bit draw per cell
+        uint32_t range = (uint32_t)(emptyCount - i);
+        int j = i + (int)(((uint64_t)(uint32_t)rng() * range) >> 32);
+        std::swap(emptyCells[i], emptyCells[j]);
+    }
     
-    std::vector<HexCoord> orderedMoves;
-    orderedMoves.reserve(moves.size());
-    for (const MonteCarloInternal::MoveScore& ms : scoredMoves) {
-        orderedMoves.push_back(ms.coord);
+    int begin = redToMove ? 0 : moverCells;
+    int end = redToMove ? moverCells : emptyCount;
+    for (int i = begin; i < end; ++i) {
+        red.set(emptyCells[i]);
     }
     
-    return orderedMoves;
+    return PathFinding::connectsEdges(red, Player::RED) ? Player::RED : Player::BLUE;
 }
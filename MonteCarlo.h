@@ -1,6 +1,13 @@
 #pragma once
 #include "HexGrid.h"
+#include "InferiorCells.h"
+#include "MoveScorer.h"
 #include "PathFinding.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <random>
 #include <vector>
 
@@ -8,27 +15,91 @@ struct MonteCarloResult {
     Move move;
     double winRate;
     int simulations;
+    int treeNodes;      // nodes allocated by the UCT search (0 in flat mode)
+    int threads;
+    double playoutsPerSecond;
+};
+
+enum class MonteCarloMode {
+    FLAT,   // fixed playouts on each of the top heuristic moves
+    TREE    // UCT tree search under a playout/time budget
 };
 
 namespace MonteCarloInternal {
-    struct MoveScore {
-        HexCoord coord;
-        double score;
+    // UCT tree node. Nodes live in MonteCarlo's preallocated arena and the
+    // children of a node occupy one contiguous block [firstChild, firstChild + childCount).
+    // Counters are atomics so several threads can share one tree.
+    struct TreeNode {
+        static const int UNEXPANDED = -1;
+        static const int EXPANDING = -2;   // another thread is writing the children
+        static const int EXHAUSTED = -3;   // arena full - stays a leaf
+        
+        std::atomic<int> firstChild;  // child block, or one of the states above
+        std::atomic<int> visits;      // includes virtual losses still in flight
+        std::atomic<int> wins;        // playouts won by the player who made `move`
+        uint8_t move;                 // cell index of the move leading to this node
+        uint8_t childCount;           // written before firstChild is published
         
-        bool operator<(const MoveScore& other) const {
-            return score > other.score; // Higher scores first
+        void init(int cell) {
+            firstChild.store(UNEXPANDED, std::memory_order_relaxed);
+            visits.store(0, std::memory_order_relaxed);
+            wins.store(0, std::memory_order_relaxed);
+            move = (uint8_t)cell;
+            childCount = 0;
         }
     };
 }
 
 class MonteCarlo {
 public:
-    MonteCarloResult findBestMove(HexGrid& grid, int simulations);
+    MonteCarlo();
+    
+    // Flat Monte Carlo: playouts for each of the top 8 heuristic moves, after
+    // dead, captured and dominated cells are pruned. Stops at `maxSimulations`
+    // playouts per move or `timeBudgetMs` (0 = no limit), whichever comes
+    // first; with neither set it gets 1 ms. Playouts go round the moves a
+    // few at a time, so every move has the same count when time runs out.
+    // With several threads this is root-parallel: each thread plays its share
+    // of every move's playouts and the per-move win counts are merged.
+    MonteCarloResult findBestMove(HexGrid& grid, int maxSimulations, int timeBudgetMs);
+    
+    // UCT tree search; stops at `maxPlayouts` or `timeBudgetMs` (0 = no limit),
+    // whichever comes first; with neither set it gets 1 ms. With several
+    // threads this is tree-parallel: all threads share one tree and use
+    // virtual loss to spread out over different lines.
+    MonteCarloResult findBestMoveUCT(HexGrid& grid, int maxPlayouts, int timeBudgetMs);
+    
+    void setThreads(int threads) { threadCount = std::max(1, threads); }
+    int getThreads() const { return threadCount; }
+    
+    // Candidate ordering goes through this scorer; share one with other engines
+    void setMoveScorer(std::shared_ptr<MoveScorer> moveScorer) { scorer = std::move(moveScorer); }
+    
+    // One fill-the-board playout from `grid` (read-only); returns the winner
+    static Player simulatePlayout(const HexGrid& grid, std::mt19937& rng);
+    
+    // Same, with the still-empty cells of fill[0] / fill[1] given to RED / BLUE
+    // up front (InferiorCells fill-in: dead and captured cells)
+    static Player simulatePlayout(const HexGrid& grid, std::mt19937& rng, const Bitboard fill[2]);
     
 private:
-    std::mt19937 rng;
+    typedef MonteCarloInternal::TreeNode TreeNode;
+    typedef std::chrono::steady_clock::time_point TimePoint;
+    
+    static const int TREE_CAPACITY = 1 << 20;  // arena size in nodes (16 MB)
+    static const int EXPAND_THRESHOLD = 1;     // visits before a leaf is expanded
+    static const int VIRTUAL_LOSS = 3;         // visits added to a node while a thread is below it
+    static const int FLAT_ROUND = 8;           // flat playouts per move between clock checks
+    
+    int threadCount;
+    std::shared_ptr<MoveScorer> scorer;
+    std::unique_ptr<TreeNode[]> arena;  // allocated once, reused by every search
+    std::atomic<int> arenaUsed;
+    Bitboard playoutFill[2];            // root fill-in of the search in progress
     
-    Player simulatePlayout(HexGrid& grid, Player originalPlayer);
-    double scoreMoveHeuristic(HexGrid& grid, const HexCoord& move, Player player);
-    std::vector<HexCoord> orderMovesByHeuristic(HexGrid& grid, const std::vector<HexCoord>& moves, Player player);
+    void treeWorker(HexGrid& grid, int root, int maxPlayouts, bool hasDeadline, TimePoint deadline,
+                    uint32_t seed, int& playouts);
+    bool expandNode(HexGrid& grid, int nodeIndex, bool heuristicOrder);
+    int selectChild(const TreeNode& parent, int firstChild) const;
+    static Player dealCells(Bitboard& red, uint8_t* emptyCells, int emptyCount, bool redToMove, std::mt19937& rng);
 };
@@ -0,0 +1,114 @@
+#include "MoveScorer.h"
+#include "PathFinding.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const uint64_t PLAYER_SALT[2] = {0xD6E8FEB86659FD93ULL, 0xA0761D6478BD642FULL};
+}
+
+constexpr double MoveScorer::WIN_SCORE;
+
+MoveScorer::MoveScorer(size_t cacheEntries) {
+    size_t size = 1;
+    while (size < cacheEntries) size <<= 1;
+    cache.resize(size);
+    cacheMask = size - 1;
+    clear();
+}
+
+void MoveScorer::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (CacheEntry& entry : cache) entry.key = 0;
+}
+
+void MoveScorer::lookup(const HexGrid& grid, Player player, float* scores) {
+    uint64_t key = grid.getHash() ^ PLAYER_SALT[player == Player::RED ? 0 : 1];
+    CacheEntry& entry = cache[key & cacheMask];
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (entry.key == key) {
+            std::memcpy(scores, entry.scores, sizeof(entry.scores));
+            return;
+        }
+    }
+    // Computed outside the lock; two threads missing together both compute
+    compute(grid, player, scores);
+    std::lock_guard<std::mutex> lock(mutex);
+    entry.key = key;
+    std::memcpy(entry.scores, scores, sizeof(entry.scores));
+}
+
+void MoveScorer::compute(const HexGrid& grid, Player player, float* scores) {
+    // Connectivity of both sides after each candidate, all from one batch of
+    // distance sweeps instead of two BFS runs per move
+    PathFinding::MoveImpact impact;
+    PathFinding::computeMoveImpacts(grid, player, impact);
+    double myConnBefore = PathFinding::connectivityScore(impact.ownBefore);
+    double oppConnBefore = PathFinding::connectivityScore(impact.opponentBefore);
+
+    // Adaptive weights based on game state
+    double offenseWeight = 1.0;
+    double defenseWeight = 1.5;  // Slightly favor defense by default
+    if (oppConnBefore > myConnBefore + 2.0) {
+        // We're behind - MUST block aggressively
+        defenseWeight = 5.0;
+        offenseWeight = 0.3;
+    } else if (oppConnBefore > myConnBefore + 1.0) {
+        // Opponent slightly ahead - heavy defense
+        defenseWeight = 3.5;
+        offenseWeight = 0.6;
+    } else if (myConnBefore > oppConnBefore + 3.0) {
+        // We're well ahead - can focus on winning
+        offenseWeight = 2.5;
+        defenseWeight = 1.0;
+    } else if (oppConnBefore > HexGrid::BOARD_SIZE * 1.5) {
+        // Opponent VERY close to winning - EMERGENCY blocking!
+        defenseWeight = 8.0;
+        offenseWeight = 0.1;
+    } else if (oppConnBefore > HexGrid::BOARD_SIZE * 1.2) {
+        // Opponent close to winning - critical blocking!
+        defenseWeight = 6.0;
+        offenseWeight = 0.2;
+    }
+
+    std::fill(scores, scores + HexGrid::CELL_COUNT, 0.0f);
+    const Bitboard& own = grid.getStones(player);
+    for (int index : grid.getEmptyCells()) {
+        // A zero-cost path is a finished chain
+        if (impact.ownAfter[index] == 0) {
+            scores[index] = (float)WIN_SCORE;
+            continue;
+        }
+
+        double myGain = PathFinding::connectivityScore(impact.ownAfter[index]) - myConnBefore;
+        double oppLoss = oppConnBefore - PathFinding::connectivityScore(impact.opponentAfter[index]);
+        double score = (myGain * offenseWeight) + (oppLoss * defenseWeight);
+
+        // Small bonus for connecting to existing stones (tie-breaker)
+        int friendlyNeighbors = 0;
+        for (int n : HexGrid::getNeighborIndices(index)) {
+            if (own.test(n)) friendlyNeighbors++;
+        }
+        score += friendlyNeighbors * 0.5;
+
+        scores[index] = (float)score;
+    }
+}
+
+std::vector<HexCoord> MoveScorer::orderMoves(const HexGrid& grid, const std::vector<HexCoord>& moves, Player player) {
+    float scores[HexGrid::CELL_COUNT];
+    lookup(grid, player, scores);
+
+    std::vector<HexCoord> ordered(moves);
+    std::stable_sort(ordered.begin(), ordered.end(), [&](const HexCoord& a, const HexCoord& b) {
+        return scores[HexGrid::toIndex(a)] > scores[HexGrid::toIndex(b)];
+    });
+    return ordered;
+}
+
+double MoveScorer::scoreMove(const HexGrid& grid, const HexCoord& move, Player player) {
+    float scores[HexGrid::CELL_COUNT];
+    lookup(grid, player, scores);
+    return scores[HexGrid::toIndex(move)];
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "HexGrid.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Connectivity-impact move scoring, shared by Minimax, MonteCarlo and the
+// AI front end. A move scores by how much it shortens the player's own
+// edge-to-edge distance and lengthens the opponent's, with weights that
+// lean further towards defence the further the player is behind.
+//
+// Scores for every empty cell come from one PathFinding::computeMoveImpacts
+// call and are cached by position key and player, so ordering a position
+// again (next iteration, other engine) is a lookup. The cache has a lock
+// and may be shared between threads.
+class MoveScorer {
+public:
+    explicit MoveScorer(size_t cacheEntries = 1024);
+
+    // `moves` (empty cells) best first for `player`; equal scores keep
+    // their order
+    std::vector<HexCoord> orderMoves(const HexGrid& grid, const std::vector<HexCoord>& moves, Player player);
+
+    // Score of one empty cell for `player`; an immediate win scores WIN_SCORE
+    double scoreMove(const HexGrid& grid, const HexCoord& move, Player player);
+
+    static constexpr double WIN_SCORE = 1000000.0;
+
+    // Forget cached scores, e.g. when a new game starts
+    void clear();
+
+private:
+    struct CacheEntry {
+        uint64_t key;   // position key ^ player salt; 0 = empty
+        float scores[HexGrid::CELL_COUNT];
+    };
+
+    std::mutex mutex;
+    std::vector<CacheEntry> cache;
+    size_t cacheMask;
+
+    // Copies the scores for (grid, player) into `scores`, computing them on a miss
+    void lookup(const HexGrid& grid, Player player, float* scores);
+    static void compute(const HexGrid& grid, Player player, float* scores);
+};
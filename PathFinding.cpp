@@ -1,152 +1,152 @@
 #include "PathFinding.h"
-#include <unordered_map>
-#include <limits>
+#include "VirtualConnections.h"
+#include <algorithm>
+
+const int PathFinding::UNREACHABLE;
 
 bool PathFinding::hasWinningPath(const HexGrid& grid, Player player) {
-    std::vector<HexCoord> startEdge, goalEdge;
-    
-    if (player == Player::RED) {
-        startEdge = grid.getTopEdge();
-        goalEdge = grid.getBottomEdge();
-    } else {
-        startEdge = grid.getLeftEdge();
-        goalEdge = grid.getRightEdge();
-    }
-    
-    std::unordered_set<HexCoord> goalSet(goalEdge.begin(), goalEdge.end());
-    std::unordered_set<HexCoord> visited;
-    std::queue<HexCoord> queue;
-    
-    for (const HexCoord& coord : startEdge) {
-        if (grid.getCell(coord) == player) {
-            queue.push(coord);
-            visited.insert(coord);
-        }
-    }
-    
-    while (!queue.empty()) {
-        HexCoord current = queue.front();
-        queue.pop();
+    return connectsEdges(grid.getStones(player), player);
+}
+
+bool PathFinding::connectsEdges(const Bitboard& stones, Player player) {
+    // Bit-parallel flood from the start edge, stopping as soon as it reaches the goal edge
+    bool red = (player == Player::RED);
+    const Bitboard& start = red ? HexGrid::TOP_ROW : HexGrid::LEFT_COLUMN;
+    const Bitboard& goal = red ? HexGrid::BOTTOM_ROW : HexGrid::RIGHT_COLUMN;
+    return (HexGrid::floodFill(stones & start, stones, goal) & goal).any();
+}
+
+namespace {
+    // 0-1 BFS: stepping onto an own stone costs 0 and goes to the front of the
+    // deque, an empty cell costs 1 and goes to the back. Cells come off the
+    // deque in distance order, so the first target cell popped is the nearest.
+    // A cell is pushed at most twice (its distance can only drop by one after
+    // the first push), so a 256-entry ring never overflows.
+    //
+    // Sources are the player's start edge (RED: top, BLUE: left), or the goal
+    // edge when `reverse` is set. Returns the distance to the opposite edge.
+    // With `fullSweep` every reachable cell gets its final distance in `dist`;
+    // otherwise the search stops at the first cell on the opposite edge.
+    int zeroOneBfs(const Bitboard& own, const Bitboard& blocked, bool red, bool reverse,
+                   bool fullSweep, int* dist) {
+        const int N = HexGrid::BOARD_SIZE;
+        const unsigned RING_MASK = 255;
+        bool settled[HexGrid::CELL_COUNT] = {};
+        uint8_t ring[RING_MASK + 1];
+        unsigned head = 0, tail = 0;
+        std::fill(dist, dist + HexGrid::CELL_COUNT, PathFinding::UNREACHABLE);
         
-        if (goalSet.find(current) != goalSet.end()) {
-            return true;
+        int sourceLine = reverse ? N - 1 : 0;
+        int targetLine = reverse ? 0 : N - 1;
+        for (int i = 0; i < N; ++i) {
+            int index = red ? sourceLine * N + i : i * N + sourceLine;
+            if (blocked.test(index)) continue;
+            if (own.test(index)) {
+                dist[index] = 0;
+                ring[--head & RING_MASK] = (uint8_t)index;
+            } else {
+                dist[index] = 1;
+                ring[tail++ & RING_MASK] = (uint8_t)index;
+            }
         }
         
-        std::vector<HexCoord> neighbors = grid.getNeighbors(current);
-        for (const HexCoord& neighbor : neighbors) {
-            if (visited.find(neighbor) == visited.end() && 
-                grid.getCell(neighbor) == player) {
-                visited.insert(neighbor);
-                queue.push(neighbor);
+        int best = PathFinding::UNREACHABLE;
+        while (head != tail) {
+            int current = ring[head++ & RING_MASK];
+            if (settled[current]) continue;  // Stale duplicate
+            settled[current] = true;
+            
+            int d = dist[current];
+            if ((red ? current / N : current % N) == targetLine) {
+                if (!fullSweep) return d;
+                best = std::min(best, d);
+            }
+            
+            for (int next : HexGrid::getNeighborIndices(current)) {
+                if (blocked.test(next)) continue;
+                bool free = own.test(next);
+                int nd = d + (free ? 0 : 1);
+                if (nd < dist[next]) {
+                    dist[next] = nd;
+                    if (free) ring[--head & RING_MASK] = (uint8_t)next;
+                    else ring[tail++ & RING_MASK] = (uint8_t)next;
+                }
             }
         }
+        return best;
     }
-    
-    return false;
 }
 
 double PathFinding::calculateConnectivity(const HexGrid& grid, Player player) {
-    std::vector<HexCoord> startEdge, goalEdge;
-    
-    if (player == Player::RED) {
-        startEdge = grid.getTopEdge();
-        goalEdge = grid.getBottomEdge();
-    } else {
-        startEdge = grid.getLeftEdge();
-        goalEdge = grid.getRightEdge();
-    }
-    
+    return connectivityScore(shortestDistance(grid, player));
+}
+
+int PathFinding::shortestDistance(const HexGrid& grid, Player player) {
+    bool red = (player == Player::RED);
+    int dist[HexGrid::CELL_COUNT];
+    return zeroOneBfs(grid.getStones(player), grid.getStones(red ? Player::BLUE : Player::RED),
+                      red, false, false, dist);
+}
+
+void PathFinding::computeDistances(const HexGrid& grid, Player player, DistanceMap& map) {
+    bool red = (player == Player::RED);
+    const Bitboard& own = grid.getStones(player);
+    const Bitboard& blocked = grid.getStones(red ? Player::BLUE : Player::RED);
+    map.shortest = zeroOneBfs(own, blocked, red, false, true, map.fromStart);
+    zeroOneBfs(own, blocked, red, true, true, map.fromGoal);
+}
+
+void PathFinding::computeMoveImpacts(const HexGrid& grid, Player player, MoveImpact& impact) {
     Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
-    std::unordered_set<HexCoord> goalSet(goalEdge.begin(), goalEdge.end());
-    
-    // Single BFS from ALL start positions at once (much faster!)
-    std::unordered_map<HexCoord, int> distances;
-    std::queue<HexCoord> queue;
-    std::unordered_set<HexCoord> visited;
-    
-    // Initialize: add all valid start edge cells to queue
-    for (const HexCoord& start : startEdge) {
-        if (grid.getCell(start) == opponent) continue; // Opponent blocks this start
-        
-        int startCost = (grid.getCell(start) == player) ? 0 : 1;
-        distances[start] = startCost;
-        queue.push(start);
-        visited.insert(start);
-    }
-    
-    // If no valid starting positions, return very low score
-    if (queue.empty()) {
-        return -100.0;
+    DistanceMap mine, theirs;
+    computeDistances(grid, player, mine);
+    computeDistances(grid, opponent, theirs);
+    impact.ownBefore = mine.shortest;
+    impact.opponentBefore = theirs.shortest;
+    
+    // Claiming empty cell c makes every path through it one cheaper; paths
+    // through c cost fromStart + fromGoal - 1 (c is counted twice), so the
+    // new shortest distance is exactly min(D, fromStart + fromGoal - 2).
+    // For the opponent c becomes a wall, which only matters if every one of
+    // their shortest paths goes through it.
+    for (int c : grid.getEmptyCells()) {
+        impact.ownAfter[c] = mine.shortest;
+        if (mine.fromStart[c] < UNREACHABLE && mine.fromGoal[c] < UNREACHABLE) {
+            impact.ownAfter[c] = std::min(mine.shortest, mine.fromStart[c] + mine.fromGoal[c] - 2);
+        }
+        impact.opponentAfter[c] = theirs.shortest;
     }
     
-    int minDistanceToGoal = std::numeric_limits<int>::max();
-    
-    // BFS to find shortest path to goal
-    while (!queue.empty()) {
-        HexCoord current = queue.front();
-        queue.pop();
-        
-        int currentDist = distances[current];
-        
-        // Early termination if we already found a better path
-        if (currentDist >= minDistanceToGoal) {
-            continue;
-        }
-        
-        // Check if we reached goal
-        if (goalSet.find(current) != goalSet.end()) {
-            minDistanceToGoal = std::min(minDistanceToGoal, currentDist);
-            continue;
-        }
-        
-        // Explore neighbors
-        std::vector<HexCoord> neighbors = grid.getNeighbors(current);
-        for (const HexCoord& neighbor : neighbors) {
-            // Skip opponent's stones
-            if (grid.getCell(neighbor) == opponent) {
-                continue;
-            }
-            
-            if (visited.find(neighbor) == visited.end()) {
-                visited.insert(neighbor);
-                
-                // Cost: 0 if we own it, 1 if empty
-                int stepCost = (grid.getCell(neighbor) == player) ? 0 : 1;
-                distances[neighbor] = currentDist + stepCost;
-                
-                queue.push(neighbor);
-            }
+    int D = theirs.shortest;
+    if (D >= UNREACHABLE || D == 0) return;
+    
+    // Along any shortest path the prefix cost rises by one at each empty cell,
+    // so every shortest path holds exactly one empty cell with fromStart == k
+    // for each k in 1..D. An empty cell on a shortest path is therefore
+    // must-pass iff it is the only such cell at its level; blocking any other
+    // leaves D unchanged.
+    int levelCount[HexGrid::CELL_COUNT + 1] = {};
+    int levelCell[HexGrid::CELL_COUNT + 1];
+    for (int c : grid.getEmptyCells()) {
+        if (theirs.fromStart[c] + theirs.fromGoal[c] - 1 == D) {
+            int level = theirs.fromStart[c];
+            levelCount[level]++;
+            levelCell[level] = c;
         }
     }
     
-    // Convert distance to connectivity score (higher = better)
-    if (minDistanceToGoal == std::numeric_limits<int>::max()) {
-        return -100.0; // Completely blocked
+    const Bitboard& theirStones = grid.getStones(opponent);
+    bool theirRed = (opponent == Player::RED);
+    int dist[HexGrid::CELL_COUNT];
+    for (int level = 1; level <= D; ++level) {
+        if (levelCount[level] != 1) continue;
+        int c = levelCell[level];
+        Bitboard walls = grid.getStones(player);
+        walls.set(c);
+        impact.opponentAfter[c] = zeroOneBfs(theirStones, walls, theirRed, false, false, dist);
     }
-    
-    // Score: lower distance = higher connectivity
-    return (HexGrid::BOARD_SIZE * 2.0) - minDistanceToGoal;
 }
 
 int PathFinding::countBridges(const HexGrid& grid, Player player) {
-    int count = 0;
-    
-    for (const auto& kv : grid.getGrid()) {
-        if (kv.second == player) {
-            std::vector<HexCoord> neighbors = grid.getNeighbors(kv.first);
-            int friendlyNeighbors = 0;
-            
-            for (const HexCoord& neighbor : neighbors) {
-                if (grid.getCell(neighbor) == player) {
-                    friendlyNeighbors++;
-                }
-            }
-            
-            if (friendlyNeighbors >= 2) {
-                count++;
-            }
-        }
-    }
-    
-    return count;
+    return VirtualConnections::countBridges(grid, player);
 }
@@ -7,7 +7,46 @@
 
 class PathFinding {
 public:
+    static const int UNREACHABLE = 1 << 20;
+    
+    // Per-cell shortest-path distances for one player, measured from each of
+    // the player's two edges. Both counts include the cell's own cost (own
+    // stone 0, empty 1); opponent stones stay UNREACHABLE.
+    struct DistanceMap {
+        int fromStart[HexGrid::CELL_COUNT];  // RED: top edge, BLUE: left edge
+        int fromGoal[HexGrid::CELL_COUNT];   // RED: bottom edge, BLUE: right edge
+        int shortest;                        // edge-to-edge distance, or UNREACHABLE
+    };
+    
+    // Shortest edge-to-edge distance of both sides after `player` claims each
+    // empty cell (entries for occupied cells are unspecified)
+    struct MoveImpact {
+        int ownBefore;
+        int opponentBefore;
+        int ownAfter[HexGrid::CELL_COUNT];
+        int opponentAfter[HexGrid::CELL_COUNT];
+    };
+
     static bool hasWinningPath(const HexGrid& grid, Player player);
+    
+    // True if `stones` link the player's two edges (RED: top-bottom, BLUE: left-right)
+    static bool connectsEdges(const Bitboard& stones, Player player);
     static double calculateConnectivity(const HexGrid& grid, Player player);
+    
+    // Edge-to-edge distance in empty cells (one BFS that stops at the goal)
+    static int shortestDistance(const HexGrid& grid, Player player);
+    
+    // Two full 0-1 BFS sweeps (one from each edge)
+    static void computeDistances(const HexGrid& grid, Player player, DistanceMap& map);
+    
+    // Scores every candidate move at once from four sweeps (two per side),
+    // plus one exact BFS per cell that all of the opponent's shortest paths
+    // must pass through
+    static void computeMoveImpacts(const HexGrid& grid, Player player, MoveImpact& impact);
+    
+    // calculateConnectivity's score for a shortest distance
+    static double connectivityScore(int distance) {
+        return distance >= UNREACHABLE ? -100.0 : HexGrid::BOARD_SIZE * 2.0 - distance;
+    }
     static int countBridges(const HexGrid& grid, Player player);
 };
@@ -0,0 +1,139 @@
+#include "ResistanceEvaluator.h"
+#include <cmath>
+
+constexpr double ResistanceEvaluator::SCALE;
+constexpr double ResistanceEvaluator::MAX_RESISTANCE;
+constexpr double ResistanceEvaluator::EMPTY_RESISTANCE;
+constexpr double ResistanceEvaluator::STONE_RESISTANCE;
+constexpr double ResistanceEvaluator::TOLERANCE;
+
+ResistanceEvaluator::ResistanceEvaluator() : lastIterations(0) {
+    // Linear drop from the source edge (1 V) to the sink edge (0 V) is a
+    // reasonable first guess for an empty board
+    for (int side = 0; side < 2; ++side) {
+        for (int index = 0; index < HexGrid::CELL_COUNT; ++index) {
+            int distance = (side == 0) ? index / HexGrid::BOARD_SIZE : index % HexGrid::BOARD_SIZE;
+            potentials[side][index] = 1.0 - (double)distance / (HexGrid::BOARD_SIZE - 1);
+        }
+    }
+}
+
+double ResistanceEvaluator::resistance(const HexGrid& grid, Player player) {
+    const int N = HexGrid::BOARD_SIZE;
+    const int CELLS = HexGrid::CELL_COUNT;
+    const bool red = (player == Player::RED);
+    const Bitboard& own = grid.getStones(player);
+    const Bitboard& wall = grid.getStones(red ? Player::BLUE : Player::RED);
+
+    // Only cells the source edge can reach carry current; if they never touch
+    // the sink edge the player is cut off and there is nothing to solve
+    Bitboard open = HexGrid::ALL_CELLS & ~wall;
+    Bitboard live = HexGrid::floodFill(open & (red ? HexGrid::TOP_ROW : HexGrid::LEFT_COLUMN), open);
+    if (!(live & (red ? HexGrid::BOTTOM_ROW : HexGrid::RIGHT_COLUMN)).any()) {
+        lastIterations = 0;
+        return MAX_RESISTANCE;
+    }
+    
+    // Build the system A x = b. Row i: diag_i * x_i - sum_k g_ik * x_nk = b_i,
+    // with the source terminal held at 1 V and the sink at 0 V. Opponent
+    // cells and unreachable pockets are out of the circuit (identity rows, x = 0).
+    double cellR[HexGrid::CELL_COUNT];
+    for (int i = 0; i < CELLS; ++i) {
+        cellR[i] = !live.test(i) ? -1.0 : (own.test(i) ? STONE_RESISTANCE : EMPTY_RESISTANCE);
+    }
+
+    double g[HexGrid::CELL_COUNT][6];
+    double sourceG[HexGrid::CELL_COUNT];
+    double diag[HexGrid::CELL_COUNT];
+    double b[HexGrid::CELL_COUNT];
+    double* x = potentials[red ? 0 : 1];
+
+    for (int i = 0; i < CELLS; ++i) {
+        sourceG[i] = 0.0;
+        if (cellR[i] < 0.0) {
+            for (int k = 0; k < 6; ++k) g[i][k] = 0.0;
+            diag[i] = 1.0;
+            b[i] = 0.0;
+            x[i] = 0.0;
+            continue;
+        }
+
+        double d = 0.0;
+        ArrayView<uint8_t> neighbors = HexGrid::getNeighborIndices(i);
+        for (int k = 0; k < neighbors.size(); ++k) {
+            int n = neighbors[k];
+            g[i][k] = cellR[n] < 0.0 ? 0.0 : 1.0 / (cellR[i] + cellR[n]);
+            d += g[i][k];
+        }
+
+        int line = red ? i / N : i % N;
+        if (line == 0) sourceG[i] = 1.0 / cellR[i];
+        if (line == N - 1) d += 1.0 / cellR[i];  // to the grounded sink
+        d += sourceG[i];
+
+        diag[i] = d;
+        b[i] = sourceG[i];
+    }
+
+    auto multiply = [&](const double* v, double* out) {
+        for (int i = 0; i < CELLS; ++i) {
+            double sum = diag[i] * v[i];
+            ArrayView<uint8_t> neighbors = HexGrid::getNeighborIndices(i);
+            for (int k = 0; k < neighbors.size(); ++k) {
+                sum -= g[i][k] * v[neighbors[k]];
+            }
+            out[i] = sum;
+        }
+    };
+
+    // Preconditioned conjugate gradient from the warm start in x
+    double r[HexGrid::CELL_COUNT], z[HexGrid::CELL_COUNT], p[HexGrid::CELL_COUNT], q[HexGrid::CELL_COUNT];
+    multiply(x, q);
+    double bNorm = 0.0, rz = 0.0, rNorm = 0.0;
+    for (int i = 0; i < CELLS; ++i) {
+        r[i] = b[i] - q[i];
+        z[i] = r[i] / diag[i];
+        p[i] = z[i];
+        rz += r[i] * z[i];
+        rNorm += r[i] * r[i];
+        bNorm += b[i] * b[i];
+    }
+
+    double threshold = TOLERANCE * TOLERANCE * bNorm;
+    int iteration = 0;
+    while (iteration < MAX_ITERATIONS && rNorm > threshold) {
+        multiply(p, q);
+        double pq = 0.0;
+        for (int i = 0; i < CELLS; ++i) pq += p[i] * q[i];
+        if (pq <= 0.0) break;
+
+        double alpha = rz / pq;
+        double rzNext = 0.0;
+        rNorm = 0.0;
+        for (int i = 0; i < CELLS; ++i) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+            z[i] = r[i] / diag[i];
+            rzNext += r[i] * z[i];
+            rNorm += r[i] * r[i];
+        }
+
+        double beta = rzNext / rz;
+        rz = rzNext;
+        for (int i = 0; i < CELLS; ++i) p[i] = z[i] + beta * p[i];
+        iteration++;
+    }
+    lastIterations = iteration;
+
+    // Total current leaving the source terminal; R = 1 V / I
+    double current = 0.0;
+    for (int i = 0; i < CELLS; ++i) {
+        current += sourceG[i] * (1.0 - x[i]);
+    }
+    return current > 1.0 / MAX_RESISTANCE ? 1.0 / current : MAX_RESISTANCE;
+}
+
+double ResistanceEvaluator::evaluate(const HexGrid& grid, Player player) {
+    Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
+    return SCALE * std::log(resistance(grid, opponent) / resistance(grid, player));
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "HexGrid.h"
+
+// Electrical-resistance evaluation: each player's board is a resistor
+// network over the flat cell graph. Empty cells have resistance 1, own
+// stones nearly 0 and opponent stones are removed; neighbouring cells are
+// joined by a resistor of r(a) + r(b), and each edge row/column is tied to
+// a terminal. The edge-to-edge resistance measures how well connected a
+// player is along ALL routes at once, not just the shortest one.
+//
+// The potentials are solved with conjugate gradient (Jacobi-preconditioned)
+// and warm-started from the previous solve for the same player, which during
+// a search is a position a move or two away. Not thread-safe: keep one per
+// search thread.
+class ResistanceEvaluator {
+public:
+    ResistanceEvaluator();
+
+    // Edge-to-edge resistance of `player`'s network (MAX_RESISTANCE if cut off)
+    double resistance(const HexGrid& grid, Player player);
+
+    // Score from `player`'s point of view: SCALE * log(R_opponent / R_player)
+    double evaluate(const HexGrid& grid, Player player);
+
+    // Conjugate-gradient iterations used by the last resistance() call
+    int getLastIterations() const { return lastIterations; }
+
+    static constexpr double SCALE = 100.0;
+    static constexpr double MAX_RESISTANCE = 1e6;
+
+private:
+    static constexpr double EMPTY_RESISTANCE = 1.0;
+    static constexpr double STONE_RESISTANCE = 0.01;
+    static constexpr double TOLERANCE = 1e-6;    // relative residual
+    static const int MAX_ITERATIONS = 200;
+
+    double potentials[2][HexGrid::CELL_COUNT];  // last solution per player (warm start)
+    int lastIterations;
+};
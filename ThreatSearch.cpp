@@ -0,0 +1,138 @@
+#include "ThreatSearch.h"
+#include "PathFinding.h"
+#include <algorithm>
+
+ThreatSearch::ThreatSearch(int maxThreats, int nodeBudget)
+    : maxThreats(maxThreats), nodeBudget(nodeBudget), nodes(0) {}
+
+ThreatSearch::Result ThreatSearch::solve(HexGrid& grid, Player player) {
+    nodes = 0;
+    touched = Bitboard();
+    int move = -1;
+    Outcome outcome = search(grid, player, maxThreats, move);
+    return Result{outcome, outcome == Outcome::UNKNOWN ? -1 : move, nodes};
+}
+
+ThreatSearch::Outcome ThreatSearch::search(HexGrid& grid, Player player, int threats, int& move) {
+    if (++nodes > nodeBudget) return Outcome::UNKNOWN;
+    Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
+
+    // Nothing to win, block or threaten: skip the full impact computation
+    int own = PathFinding::shortestDistance(grid, player);
+    if (own > 1 && (threats == 0 || own > 2) && PathFinding::shortestDistance(grid, opponent) > 1) {
+        return Outcome::UNKNOWN;
+    }
+
+    PathFinding::MoveImpact impact;
+    PathFinding::computeMoveImpacts(grid, player, impact);
+
+    // Candidates are collected before any of them is tried, since trying
+    // one changes the board underneath
+    uint8_t cells[HexGrid::CELL_COUNT];
+    int count = 0;
+
+    if (impact.ownBefore <= 1) {
+        for (int index : grid.getEmptyCells()) {
+            if (impact.ownAfter[index] == 0) {
+                move = index;
+                return Outcome::WIN;
+            }
+        }
+    }
+
+    if (impact.opponentBefore <= 1) {
+        // Forced: block every winning cell of the opponent at once, or lose
+        for (int index : grid.getEmptyCells()) {
+            if (impact.opponentAfter[index] > 1) cells[count++] = (uint8_t)index;
+        }
+        if (count == 0) return Outcome::LOSS;
+
+        bool allLose = true;
+        for (int i = 0; i < count; ++i) {
+            int reply = -1;
+            grid.simulateMove(HexGrid::fromIndex(cells[i]), player);
+            touched.set(cells[i]);
+            Outcome result = search(grid, opponent, threats, reply);
+            grid.undoSimulation(HexGrid::fromIndex(cells[i]));
+
+            if (result == Outcome::LOSS) {
+                move = cells[i];
+                return Outcome::WIN;
+            }
+            if (result != Outcome::WIN) allLose = false;
+        }
+        if (allLose) move = cells[0];
+        return allLose ? Outcome::LOSS : Outcome::UNKNOWN;
+    }
+
+    if (threats == 0) return Outcome::UNKNOWN;
+
+    // Attack: moves that leave us one stone from connecting
+    for (int index : grid.getEmptyCells()) {
+        if (impact.ownAfter[index] == 1) cells[count++] = (uint8_t)index;
+    }
+    for (int i = 0; i < count; ++i) {
+        int reply = -1;
+        grid.simulateMove(HexGrid::fromIndex(cells[i]), player);
+        touched.set(cells[i]);
+        Outcome result = search(grid, opponent, threats - 1, reply);
+        grid.undoSimulation(HexGrid::fromIndex(cells[i]));
+
+        if (result == Outcome::LOSS) {
+            move = cells[i];
+            return Outcome::WIN;
+        }
+        if (nodes > nodeBudget) break;
+    }
+    return Outcome::UNKNOWN;
+}
+
+std::vector<HexCoord> ThreatSearch::findDefences(HexGrid& grid, Player player, const std::vector<HexCoord>& candidates,
+                                                 int nodeLimit) {
+    Player opponent = (player == Player::RED) ? Player::BLUE : Player::RED;
+    std::vector<HexCoord> defences;
+
+    // Each solve keeps its own budget but draws on the shared allowance
+    int solveBudget = nodeBudget;
+    int remaining = nodeLimit;
+    auto solveWithin = [&](Player side) {
+        nodeBudget = std::min(solveBudget, remaining);
+        Outcome outcome = solve(grid, side).outcome;
+        remaining -= nodes;
+        nodeBudget = solveBudget;
+        return outcome;
+    };
+
+    if (solveWithin(opponent) != Outcome::WIN) return defences;
+
+    // Every candidate is tried, since a counter-threat anywhere can refute
+    // the proof. Cells that disturb it directly (ones it played, or ones all
+    // of the opponent's shortest paths run through) go first, in case the
+    // allowance runs out.
+    PathFinding::MoveImpact impact;
+    PathFinding::computeMoveImpacts(grid, player, impact);
+    Bitboard likely = touched;
+    for (int index : grid.getEmptyCells()) {
+        if (impact.opponentAfter[index] > impact.opponentBefore) likely.set(index);
+    }
+    std::vector<HexCoord> ordered;
+    ordered.reserve(candidates.size());
+    for (const HexCoord& coord : candidates) {
+        if (likely.test(HexGrid::toIndex(coord))) ordered.push_back(coord);
+    }
+    for (const HexCoord& coord : candidates) {
+        if (!likely.test(HexGrid::toIndex(coord))) ordered.push_back(coord);
+    }
+
+    for (const HexCoord& coord : ordered) {
+        if (remaining <= 0) {
+            defences.push_back(coord);
+            continue;
+        }
+        grid.simulateMove(coord, player);
+        Outcome result = solveWithin(opponent);
+        grid.undoSimulation(coord);
+        if (result != Outcome::WIN) defences.push_back(coord);
+    }
+    return defences;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "HexGrid.h"
+#include <vector>
+
+// Threat-space search: looks only at forcing moves, so it can read long
+// tactical sequences that a full-width search would prune away.
+//   - A threat is a move that leaves its player one stone from connecting.
+//   - The defender must then block: the only candidates are the cells that
+//     raise the attacker's distance above 1 (PathFinding::computeMoveImpacts
+//     gives this exactly for every cell at once). No block means a loss.
+// WIN and LOSS are proofs. UNKNOWN means no forced line was found within
+// the threat and node limits; the position may still be won or lost.
+class ThreatSearch {
+public:
+    enum class Outcome { UNKNOWN, WIN, LOSS };   // for the player to move
+
+    struct Result {
+        Outcome outcome;
+        int move;    // winning (or forced) cell index, -1 if none
+        int nodes;
+    };
+
+    // maxThreats: attacker threats per line; nodeBudget: nodes per solve()
+    ThreatSearch(int maxThreats = 3, int nodeBudget = 5000);
+
+    // Forced result for `player` moving next on `grid`. The grid is restored.
+    Result solve(HexGrid& grid, Player player);
+
+    // If the opponent of `player` would win by threats were it their move,
+    // the cells of `candidates` after which that win is no longer proven.
+    // Empty when there is no such threat (or nothing refutes it).
+    // All the solves share `nodeLimit` nodes; candidates left untried when
+    // it runs out are kept. A dropped candidate is therefore a proven loss,
+    // and the list is safe to restrict a search to.
+    std::vector<HexCoord> findDefences(HexGrid& grid, Player player, const std::vector<HexCoord>& candidates,
+                                       int nodeLimit);
+
+private:
+    int maxThreats;
+    int nodeBudget;
+    int nodes;
+    Bitboard touched;   // cells played anywhere in the last search
+
+    Outcome search(HexGrid& grid, Player player, int threats, int& move);
+};
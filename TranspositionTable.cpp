@@ -0,0 +1,92 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(size_t megabytes) : slotCount(0), bucketMask(0), generation(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    size_t bytes = (megabytes > 0 ? megabytes : 1) * 1024 * 1024;
+    size_t maxBuckets = bytes / (sizeof(Slot) * BUCKET_SIZE);
+    
+    // Round down to a power of two so the bucket index is a mask
+    size_t buckets = 1;
+    while (buckets * 2 <= maxBuckets) {
+        buckets *= 2;
+    }
+    
+    slotCount = buckets * BUCKET_SIZE;
+    slots.reset(new Slot[slotCount]);
+    bucketMask = buckets - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < slotCount; ++i) {
+        slots[i].check.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
+    }
+    generation = 0;
+}
+
+bool TranspositionTable::read(const Slot& slot, TTEntry& entry) {
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    
+    entry.key = check ^ data;
+    entry.move = (int16_t)(uint16_t)(data & 0xFFFF);
+    entry.depth = (int8_t)(uint8_t)((data >> 16) & 0xFF);
+    entry.bound = (BoundType)((data >> 24) & 0xFF);
+    entry.generation = (uint8_t)((data >> 32) & 0xFF);
+    entry.score = (int32_t)(data >> 40);
+    if (entry.score & 0x800000) entry.score -= 0x1000000;  // sign-extend 24 bits
+    return entry.bound != BoundType::NONE;
+}
+
+void TranspositionTable::write(Slot& slot, const TTEntry& entry) {
+    uint64_t data = (uint64_t)(uint16_t)entry.move
+                  | ((uint64_t)(uint8_t)entry.depth << 16)
+                  | ((uint64_t)entry.bound << 24)
+                  | ((uint64_t)entry.generation << 32)
+                  | ((uint64_t)((uint32_t)entry.score & 0xFFFFFF) << 40);
+    
+    slot.check.store(entry.key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    Slot* bucket = bucketFor(key);
+    for (int i = 0; i < BUCKET_SIZE; ++i) {
+        if (read(bucket[i], entry) && entry.key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, BoundType bound, int score, int move) {
+    Slot* bucket = bucketFor(key);
+    TTEntry deep, recent;
+    bool hasDeep = read(bucket[0], deep);
+    bool hasRecent = read(bucket[1], recent);
+    
+    // Keep the best move we already know if this search didn't produce one
+    if (move < 0) {
+        if (hasDeep && deep.key == key) move = deep.move;
+        else if (hasRecent && recent.key == key) move = recent.move;
+    }
+    
+    TTEntry entry{key, score, (int16_t)move, (int8_t)depth, bound, generation};
+    
+    bool deepIsUsable = hasDeep && deep.generation == generation;
+    if (!deepIsUsable || deep.key == key || depth >= deep.depth) {
+        // Demote a different, still useful entry to the always-replace slot
+        if (deepIsUsable && deep.key != key) {
+            write(bucket[1], deep);
+        } else if (hasRecent && recent.key == key) {
+            write(bucket[1], TTEntry{0, 0, -1, 0, BoundType::NONE, 0});
+        }
+        write(bucket[0], entry);
+    } else {
+        write(bucket[1], entry);
+    }
+}
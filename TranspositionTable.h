@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+enum class BoundType : uint8_t {
+    NONE = 0,
+    EXACT = 1,   // score is the true minimax value
+    LOWER = 2,   // search failed high: true value >= score
+    UPPER = 3    // search failed low:  true value <= score
+};
+
+struct TTEntry {
+    uint64_t key;
+    int32_t score;       // fixed-point, from the side to move's point of view
+    int16_t move;        // best cell index, -1 if none
+    int8_t depth;        // remaining depth the score was searched to
+    BoundType bound;
+    uint8_t generation;  // search that last wrote the entry
+};
+
+// Fixed-size hash table of searched positions, keyed by HexGrid::getHash().
+// Each bucket holds two entries: a depth-preferred slot that only yields to
+// deeper (or stale) results, and an always-replace slot for everything else.
+//
+// The table is shared lock-free between search threads. A slot is two
+// relaxed atomic words and the stored check word is key ^ data, so a slot
+// torn by two concurrent writers simply fails verification on probe.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes = 16);
+    
+    void resize(size_t megabytes);
+    void clear();
+    
+    // Start a new search; entries from older searches become replaceable
+    void newSearch() { generation++; }
+    
+    bool probe(uint64_t key, TTEntry& entry) const;
+    void store(uint64_t key, int depth, BoundType bound, int score, int move);
+    
+    size_t getEntryCount() const { return slotCount; }
+    
+private:
+    static const int BUCKET_SIZE = 2;
+    
+    struct Slot {
+        std::atomic<uint64_t> check;  // key ^ data
+        std::atomic<uint64_t> data;   // move | depth | bound | generation | 24-bit score
+    };
+    
+    std::unique_ptr<Slot[]> slots;
+    size_t slotCount;
+    size_t bucketMask;
+    uint8_t generation;
+    
+    Slot* bucketFor(uint64_t key) const { return &slots[(key & bucketMask) * BUCKET_SIZE]; }
+    
+    static bool read(const Slot& slot, TTEntry& entry);
+    static void write(Slot& slot, const TTEntry& entry);
+};
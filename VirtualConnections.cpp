@@ -0,0 +1,206 @@
+#include "VirtualConnections.h"
+#include "PathFinding.h"
+#include <algorithm>
+
+namespace {
+    const int N = HexGrid::BOARD_SIZE;
+    const int DQ[6] = {1, 1, 0, -1, -1, 0};
+    const int DR[6] = {0, -1, -1, 0, 1, 1};
+
+    constexpr bool onBoard(int q, int r) { return q >= 0 && q < N && r >= 0 && r < N; }
+
+    // Bridge k of a cell spans directions k and k + 1 (consecutive directions
+    // are adjacent), so the partner sits at DIR[k] + DIR[k + 1] and the two
+    // carrier cells at DIR[k] and DIR[k + 1]. Bridges k and k + 3 point in
+    // opposite directions.
+    struct BridgeTable {
+        int8_t partner[HexGrid::CELL_COUNT][6];   // -1 if off the board
+        Bitboard carrier[HexGrid::CELL_COUNT][6];
+
+        constexpr BridgeTable() : partner{}, carrier{} {
+            for (int index = 0; index < HexGrid::CELL_COUNT; ++index) {
+                int q = index % N, r = index / N;
+                for (int k = 0; k < 6; ++k) {
+                    int k2 = (k + 1) % 6;
+                    int pq = q + DQ[k] + DQ[k2], pr = r + DR[k] + DR[k2];
+                    partner[index][k] = -1;
+                    if (!onBoard(pq, pr)) continue;
+                    partner[index][k] = (int8_t)(pr * N + pq);
+                    carrier[index][k].set((r + DR[k]) * N + q + DQ[k]);
+                    carrier[index][k].set((r + DR[k2]) * N + q + DQ[k2]);
+                }
+            }
+        }
+    };
+
+    // Edge templates written for the top edge as (dq, dr) offsets from the
+    // stone, row distance 1 (template II) or 2 (ziggurat, both mirror images)
+    struct Pattern {
+        int rowDistance;
+        int size;
+        int dq[8];
+        int dr[8];
+    };
+    constexpr Pattern PATTERNS[3] = {
+        {1, 2, {0, 1}, {-1, -1}},
+        {2, 8, {1, 0, 1, 2, 0, 1, 2, 3}, {0, -1, -1, -1, -2, -2, -2, -2}},
+        {2, 8, {-1, 0, 1, -1, -1, 0, 1, 2}, {0, -1, -1, -1, -2, -2, -2, -2}},
+    };
+
+    enum Edge { TOP = 0, BOTTOM = 1, LEFT = 2, RIGHT = 3 };
+
+    // Per edge and cell, up to two template carriers (empty = no template).
+    // The other edges reuse the top-edge patterns through board symmetries:
+    // bottom is the 180-degree rotation, left the transpose (q, r) -> (r, q),
+    // right both; all three preserve hex adjacency.
+    struct TemplateTable {
+        Bitboard carrier[4][HexGrid::CELL_COUNT][2];
+
+        constexpr TemplateTable() : carrier{} {
+            for (int edge = 0; edge < 4; ++edge) {
+                for (int index = 0; index < HexGrid::CELL_COUNT; ++index) {
+                    int q = index % N, r = index / N;
+                    int distance = edge == TOP ? r : edge == BOTTOM ? N - 1 - r : edge == LEFT ? q : N - 1 - q;
+                    int slot = 0;
+                    for (const Pattern& pattern : PATTERNS) {
+                        if (pattern.rowDistance != distance) continue;
+                        Bitboard cells;
+                        bool fits = true;
+                        for (int c = 0; c < pattern.size; ++c) {
+                            int dq = pattern.dq[c], dr = pattern.dr[c];
+                            int tq = edge == TOP ? dq : edge == BOTTOM ? -dq : edge == LEFT ? dr : -dr;
+                            int tr = edge == TOP ? dr : edge == BOTTOM ? -dr : edge == LEFT ? dq : -dq;
+                            if (!onBoard(q + tq, r + tr)) { fits = false; break; }
+                            cells.set((r + tr) * N + q + tq);
+                        }
+                        if (fits) carrier[edge][index][slot++] = cells;
+                    }
+                }
+            }
+        }
+    };
+
+    constexpr BridgeTable BRIDGES;
+    constexpr TemplateTable TEMPLATES;
+
+    const uint64_t PLAYER_SALT[2] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL};
+
+    // Own stones tied to `edge` by an intact template
+    Bitboard templateLinked(const Bitboard& own, const Bitboard& blocked, int edge) {
+        Bitboard linked;
+        for (int index = 0; index < HexGrid::CELL_COUNT; ++index) {
+            if (!own.test(index)) continue;
+            for (int slot = 0; slot < 2; ++slot) {
+                const Bitboard& cells = TEMPLATES.carrier[edge][index][slot];
+                if (cells.any() && !(cells & blocked).any()) {
+                    linked.set(index);
+                    break;
+                }
+            }
+        }
+        return linked;
+    }
+}
+
+VirtualConnections::VirtualConnections(size_t cacheEntries) {
+    size_t size = 1;
+    while (size < cacheEntries) size <<= 1;
+    cache.assign(size, CacheEntry{0, Summary{0, 0, 0}});
+    cacheMask = size - 1;
+}
+
+const VirtualConnections::Summary& VirtualConnections::analyze(const HexGrid& grid, Player player) {
+    uint64_t key = grid.getHash() ^ PLAYER_SALT[player == Player::RED ? 0 : 1];
+    CacheEntry& entry = cache[key & cacheMask];
+    if (entry.key != key) {
+        entry.key = key;
+        entry.summary = compute(grid, player);
+    }
+    return entry.summary;
+}
+
+int VirtualConnections::countBridges(const HexGrid& grid, Player player) {
+    const Bitboard& own = grid.getStones(player);
+    Bitboard occupied = grid.getStones(Player::RED) | grid.getStones(Player::BLUE);
+    int count = 0;
+    for (int index = 0; index < HexGrid::CELL_COUNT; ++index) {
+        if (!own.test(index)) continue;
+        // Directions 0-2 only, so each pair is counted once
+        for (int k = 0; k < 3; ++k) {
+            int partner = BRIDGES.partner[index][k];
+            if (partner >= 0 && own.test(partner) && !(BRIDGES.carrier[index][k] & occupied).any()) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+VirtualConnections::Summary VirtualConnections::compute(const HexGrid& grid, Player player) {
+    const bool red = (player == Player::RED);
+    const Bitboard& own = grid.getStones(player);
+    const Bitboard& blocked = grid.getStones(red ? Player::BLUE : Player::RED);
+    Bitboard startLinked = templateLinked(own, blocked, red ? TOP : LEFT);
+    Bitboard goalLinked = templateLinked(own, blocked, red ? BOTTOM : RIGHT);
+
+    Summary summary;
+    summary.bridges = countBridges(grid, player);
+    summary.edgeTemplates = (startLinked | goalLinked).count();
+
+    // 0-1 BFS as in PathFinding::calculateConnectivity, with two additions:
+    // own stones joined by an intact bridge are 0 apart, and stones held to
+    // an edge by a template count as lying on that edge
+    const unsigned RING_MASK = 255;
+    int dist[HexGrid::CELL_COUNT];
+    bool settled[HexGrid::CELL_COUNT] = {};
+    uint8_t ring[RING_MASK + 1];
+    unsigned head = 0, tail = 0;
+    std::fill(dist, dist + HexGrid::CELL_COUNT, PathFinding::UNREACHABLE);
+
+    for (int index = 0; index < HexGrid::CELL_COUNT; ++index) {
+        bool onStart = (red ? index / N : index % N) == 0;
+        if (blocked.test(index) || !(onStart || startLinked.test(index))) continue;
+        if (own.test(index)) {
+            dist[index] = 0;
+            ring[--head & RING_MASK] = (uint8_t)index;
+        } else {
+            dist[index] = 1;
+            ring[tail++ & RING_MASK] = (uint8_t)index;
+        }
+    }
+
+    summary.distance = PathFinding::UNREACHABLE;
+    while (head != tail) {
+        int current = ring[head++ & RING_MASK];
+        if (settled[current]) continue;
+        settled[current] = true;
+
+        int d = dist[current];
+        if ((red ? current / N : current % N) == N - 1 || goalLinked.test(current)) {
+            summary.distance = d;
+            break;
+        }
+
+        for (int next : HexGrid::getNeighborIndices(current)) {
+            if (blocked.test(next)) continue;
+            bool free = own.test(next);
+            int nd = d + (free ? 0 : 1);
+            if (nd < dist[next]) {
+                dist[next] = nd;
+                if (free) ring[--head & RING_MASK] = (uint8_t)next;
+                else ring[tail++ & RING_MASK] = (uint8_t)next;
+            }
+        }
+
+        if (own.test(current)) {
+            for (int k = 0; k < 6; ++k) {
+                int partner = BRIDGES.partner[current][k];
+                if (partner < 0 || !own.test(partner) || d >= dist[partner]) continue;
+                if ((BRIDGES.carrier[current][k] & blocked).any()) continue;
+                dist[partner] = d;
+                ring[--head & RING_MASK] = (uint8_t)partner;
+            }
+        }
+    }
+    return summary;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "HexGrid.h"
+#include <cstdint>
+#include <vector>
+
+// Virtual connections: links the opponent cannot cut with one move.
+//   - Bridge: two own stones two cells apart with both shared neighbours
+//     (the carrier) free of opponent stones.
+//   - Edge template II: a stone on the second row whose two edge-row
+//     neighbours are free.
+//   - Edge template IIIa (ziggurat): a stone on the third row with an
+//     8-cell carrier free, in either of its two mirror orientations.
+// All patterns are precomputed carrier bitmasks, so a check is one AND.
+// Carriers of different connections may overlap; that is ignored, as is
+// usual for an evaluation heuristic.
+class VirtualConnections {
+public:
+    // Per-player summary of one position
+    struct Summary {
+        int bridges;        // intact bridges between two own stones
+        int edgeTemplates;  // own stones tied to one of the player's edges by a template
+        int distance;       // edge-to-edge 0-1 distance with VC-linked groups merged
+    };
+
+    explicit VirtualConnections(size_t cacheEntries = 4096);
+
+    // Summary for `player`, cached by the position's Zobrist key. Not
+    // thread-safe: keep one instance per search thread.
+    const Summary& analyze(const HexGrid& grid, Player player);
+
+    // Uncached building blocks
+    static Summary compute(const HexGrid& grid, Player player);
+    static int countBridges(const HexGrid& grid, Player player);
+
+private:
+    struct CacheEntry {
+        uint64_t key;   // position key ^ player salt; 0 = empty
+        Summary summary;
+    };
+
+    std::vector<CacheEntry> cache;
+    size_t cacheMask;
+};
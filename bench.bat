@@ -0,0 +1,30 @@
+@echo off
+echo ========================================
+echo Building Hex benchmark (headless)
+echo ========================================
+echo.
+
+if not exist "build" mkdir build
+
+g++ -std=c++14 -O2 -Wall ^
+    -o build\bench.exe ^
+    bench.cpp ^
+    HexGrid.cpp ^
+    PathFinding.cpp ^
+    TranspositionTable.cpp ^
+    ResistanceEvaluator.cpp ^
+    VirtualConnections.cpp ^
+    InferiorCells.cpp ^
+    MoveScorer.cpp ^
+    ThreatSearch.cpp ^
+    EndgameSolver.cpp ^
+    Minimax.cpp ^
+    MonteCarlo.cpp ^
+    -pthread
+
+if %ERRORLEVEL% NEQ 0 (
+    echo BUILD FAILED!
+    exit /b 1
+)
+
+build\bench.exe %*
@@ -0,0 +1,373 @@
+// Headless benchmark harness for the engine hot paths.
+// Builds without the Win32 GUI (see bench.sh / bench.bat) and reports
+// ns/op, allocations/op and nodes or playouts per second over a fixed
+// corpus of opening, midgame and endgame positions.
+//
+//   bench [--json] [--min-time MS] [FILTER]
+//   bench --match GAMES [--move-time MS]
+//
+// FILTER is a substring matched against "benchmark/position". --match plays
+// the two Minimax evaluators against each other at equal time per move.
+#include "EndgameSolver.h"
+#include "HexGrid.h"
+#include "PathFinding.h"
+#include "InferiorCells.h"
+#include "Minimax.h"
+#include "MonteCarlo.h"
+#include "ThreatSearch.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// Global allocation counter: every operator new in the process is counted
+static std::atomic<long long> g_allocations(0);
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// Results are folded in here so the optimizer can't drop the timed calls
+volatile long long g_sink = 0;
+
+struct Position {
+    const char* name;
+    const char* moves;  // column letter a-k = q, number 1-11 = r + 1
+};
+
+// Fixed corpus; every position is still undecided
+const Position CORPUS[] = {
+    {"opening4",  "e8 d6 g6 e4"},
+    {"opening6",  "g7 f6 g5 h7 g4 f4"},
+    {"midgame28", "g6 h5 g5 e8 h7 f5 d5 f8 c9 j11 e1 c11 a1 d4 i5 d9 b6 f7 f11 j7 d6 d8 h3 i4 c6 b8 g4 j1"},
+    {"midgame34", "d7 h8 h6 f8 f6 f7 e4 d5 k10 c11 j5 g5 e1 i8 d11 h1 k4 c6 i10 d3 c2 a4 b7 b11 c4 d4 d1 d10 "
+                  "h10 d2 k11 g11 d9 b1"},
+    {"endgame70", "f8 d7 h5 h8 g4 f7 h4 e8 e7 b8 k11 c11 j7 d2 a10 j5 d1 d9 h11 g5 e1 f5 h10 k10 c8 h6 j11 d5 "
+                  "d6 j1 g6 i4 e11 k4 k1 h7 h3 i3 e3 f3 c2 j6 g10 a11 f11 i10 a5 j2 b11 b5 d10 f2 f4 c10 a7 i7 "
+                  "b4 k6 c7 h2 g1 j9 b6 e2 k7 d4 c9 k8 a4 j8"},
+    {"endgame84", "e7 d7 f7 h6 h5 g4 e8 f8 h9 j3 j6 i10 a9 j7 i6 b6 d8 a4 a1 j4 d4 i3 k9 g10 k8 a2 j5 g8 a8 "
+                  "j2 k3 j8 h11 f4 k11 b2 j9 g11 a3 h3 j10 g9 i5 f2 b5 f3 i9 b10 c2 a7 f11 e11 h4 c10 g7 h1 e1 "
+                  "d6 e3 k4 c8 d10 k5 f9 c1 d1 c7 k6 d11 c5 h8 f1 g6 i1 e9 b7 c6 c9 d3 c11 d5 f10 b4 e6"},
+};
+
+bool loadPosition(const Position& position, HexGrid& grid) {
+    grid.reset();
+    const char* p = position.moves;
+    while (*p) {
+        while (*p == ' ') p++;
+        if (!*p) break;
+        int q = *p++ - 'a';
+        int r = 0;
+        while (*p >= '0' && *p <= '9') r = r * 10 + (*p++ - '0');
+        if (!grid.makeMove(HexCoord(q, r - 1))) return false;
+    }
+    return grid.getWinner() == Player::NONE;
+}
+
+// What one call of a benchmark body did
+struct Work {
+    long long ops;    // operations timed (ns/op and allocs/op divide by this)
+    long long units;  // search nodes or playouts (0 if not applicable)
+};
+
+struct BenchResult {
+    std::string benchmark;
+    std::string position;
+    long long ops;
+    double nsPerOp;
+    double allocsPerOp;
+    double nodesPerSec;
+    double playoutsPerSec;
+};
+
+enum class UnitKind { NONE, NODES, PLAYOUTS };
+
+struct Options {
+    bool json = false;
+    int minTimeMs = 200;
+    std::string filter;
+    int matchGames = 0;
+    int moveTimeMs = 100;
+};
+
+class Runner {
+public:
+    explicit Runner(const Options& options) : options(options) {}
+
+    void run(const std::string& benchmark, const Position& position, UnitKind kind,
+             const std::function<Work()>& body) {
+        std::string id = benchmark + "/" + position.name;
+        if (!options.filter.empty() && id.find(options.filter) == std::string::npos) return;
+
+        body();  // warm-up (caches, lazily sized tables)
+
+        typedef std::chrono::steady_clock Clock;
+        long long ops = 0, units = 0;
+        long long allocsBefore = g_allocations.load(std::memory_order_relaxed);
+        Clock::time_point start = Clock::now();
+        double elapsedNs = 0.0;
+        do {
+            Work work = body();
+            ops += work.ops;
+            units += work.units;
+            elapsedNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        } while (elapsedNs < options.minTimeMs * 1e6);
+        long long allocs = g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+
+        BenchResult result;
+        result.benchmark = benchmark;
+        result.position = position.name;
+        result.ops = ops;
+        result.nsPerOp = elapsedNs / ops;
+        result.allocsPerOp = (double)allocs / ops;
+        double perSecond = units * 1e9 / elapsedNs;
+        result.nodesPerSec = kind == UnitKind::NODES ? perSecond : 0.0;
+        result.playoutsPerSec = kind == UnitKind::PLAYOUTS ? perSecond : 0.0;
+        results.push_back(result);
+
+        if (!options.json) {
+            std::printf("%-28s %-10s %14.1f ns/op %10.2f allocs/op", benchmark.c_str(), position.name,
+                        result.nsPerOp, result.allocsPerOp);
+            if (kind == UnitKind::NODES) std::printf(" %12.0f nodes/s", result.nodesPerSec);
+            if (kind == UnitKind::PLAYOUTS) std::printf(" %12.0f playouts/s", result.playoutsPerSec);
+            std::printf("\n");
+            std::fflush(stdout);
+        }
+    }
+
+    void printJson() const {
+        std::printf("[\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            std::printf("  {\"benchmark\": \"%s\", \"position\": \"%s\", \"ops\": %lld, \"ns_per_op\": %.2f, "
+                        "\"allocs_per_op\": %.4f, \"nodes_per_sec\": %.1f, \"playouts_per_sec\": %.1f}%s\n",
+                        r.benchmark.c_str(), r.position.c_str(), r.ops, r.nsPerOp, r.allocsPerOp,
+                        r.nodesPerSec, r.playoutsPerSec, i + 1 < results.size() ? "," : "");
+        }
+        std::printf("]\n");
+    }
+
+private:
+    Options options;
+    std::vector<BenchResult> results;
+};
+
+std::vector<HexCoord> emptyCells(const HexGrid& grid) {
+    std::vector<HexCoord> cells;
+    for (const auto& cell : grid.getGrid()) {
+        if (cell.second == Player::NONE) cells.push_back(cell.first);
+    }
+    return cells;
+}
+
+void runPosition(Runner& runner, const Position& position) {
+    HexGrid grid;
+    if (!loadPosition(position, grid)) {
+        std::fprintf(stderr, "bench: invalid corpus position %s\n", position.name);
+        std::exit(1);
+    }
+    const std::vector<HexCoord> empty = emptyCells(grid);
+    const int batch = 1000;
+
+    runner.run("grid.getWinner", position, UnitKind::NONE, [&]() {
+        int decided = 0;
+        for (int i = 0; i < batch; i++) decided += grid.getWinner() != Player::NONE;
+        g_sink = g_sink + decided;
+        return Work{batch, 0};
+    });
+
+    runner.run("grid.makeUndo", position, UnitKind::NONE, [&]() {
+        for (const HexCoord& cell : empty) {
+            grid.makeMove(cell);
+            grid.undoMove();
+        }
+        return Work{(long long)empty.size(), 0};
+    });
+
+    runner.run("path.hasWinningPath", position, UnitKind::NONE, [&]() {
+        int found = 0;
+        for (int i = 0; i < batch; i++) {
+            found += PathFinding::hasWinningPath(grid, i & 1 ? Player::BLUE : Player::RED);
+        }
+        g_sink = g_sink + found;
+        return Work{batch, 0};
+    });
+
+    runner.run("path.calculateConnectivity", position, UnitKind::NONE, [&]() {
+        double sum = 0.0;
+        for (int i = 0; i < 100; i++) {
+            sum += PathFinding::calculateConnectivity(grid, i & 1 ? Player::BLUE : Player::RED);
+        }
+        g_sink = g_sink + (long long)sum;
+        return Work{100, 0};
+    });
+
+    runner.run("inferior.analyze", position, UnitKind::NONE, [&]() {
+        InferiorCells::Analysis analysis;
+        int pruned = 0;
+        for (int i = 0; i < 100; i++) {
+            InferiorCells::analyze(grid, analysis);
+            pruned += grid.getEmptyCount() - analysis.candidates.count();
+        }
+        g_sink = g_sink + pruned;
+        return Work{100, 0};
+    });
+
+    runner.run("threat.solve", position, UnitKind::NODES, [&]() {
+        ThreatSearch search(4, 20000);
+        ThreatSearch::Result result = search.solve(grid, grid.getCurrentPlayer());
+        return Work{1, (long long)result.nodes};
+    });
+
+    runner.run("solver.solve", position, UnitKind::NODES, [&]() {
+        EndgameSolver solver(1);
+        EndgameSolver::Result result = solver.solve(grid, 20000);
+        return Work{1, result.nodes};
+    });
+
+    runner.run("minimax.depth2", position, UnitKind::NODES, [&]() {
+        Minimax minimax(1);
+        minimax.setThreads(1);
+        MinimaxResult result = minimax.findBestMove(grid, 2);
+        return Work{1, (long long)result.nodesEvaluated};
+    });
+
+    runner.run("minimax.depth4", position, UnitKind::NODES, [&]() {
+        Minimax minimax(16);
+        minimax.setThreads(1);
+        MinimaxResult result = minimax.findBestMove(grid, 4);
+        return Work{1, (long long)result.nodesEvaluated};
+    });
+
+    runner.run("minimax.depth2.resistance", position, UnitKind::NODES, [&]() {
+        Minimax minimax(1);
+        minimax.setThreads(1);
+        minimax.setEvaluator(EvaluatorType::RESISTANCE);
+        MinimaxResult result = minimax.findBestMove(grid, 2);
+        return Work{1, (long long)result.nodesEvaluated};
+    });
+
+    std::mt19937 rng(12345);
+    runner.run("montecarlo.simulatePlayout", position, UnitKind::PLAYOUTS, [&]() {
+        int redWins = 0;
+        for (int i = 0; i < batch; i++) redWins += MonteCarlo::simulatePlayout(grid, rng) == Player::RED;
+        g_sink = g_sink + redWins;
+        return Work{batch, batch};
+    });
+
+    runner.run("montecarlo.uct2000", position, UnitKind::PLAYOUTS, [&]() {
+        MonteCarlo monteCarlo;
+        monteCarlo.setThreads(1);
+        MonteCarloResult result = monteCarlo.findBestMoveUCT(grid, 2000, 0);
+        return Work{1, (long long)result.simulations};
+    });
+}
+
+// Connectivity vs resistance evaluator at equal time per move. Each pair of
+// games starts from the same two random opening stones with colours swapped.
+void runMatch(const Options& options) {
+    const EvaluatorType types[2] = {EvaluatorType::CONNECTIVITY, EvaluatorType::RESISTANCE};
+    const char* names[2] = {"connectivity", "resistance"};
+    int wins[2] = {0, 0};
+    double nodes[2] = {0.0, 0.0};
+    double seconds[2] = {0.0, 0.0};
+
+    for (int game = 0; game < options.matchGames; game++) {
+        std::mt19937 rng(1000 + game / 2);
+        HexGrid grid;
+        for (int i = 0; i < 2; i++) {
+            grid.makeMove(HexGrid::fromIndex(grid.getEmptyCells()[rng() % grid.getEmptyCount()]));
+        }
+
+        // engine[0] plays RED in even games, BLUE in odd ones
+        Minimax engines[2];
+        for (int e = 0; e < 2; e++) {
+            engines[e].setThreads(1);
+            engines[e].setEvaluator(types[e]);
+        }
+        SearchLimits limits{32, options.moveTimeMs, 0};
+        while (grid.getWinner() == Player::NONE) {
+            bool redToMove = grid.getCurrentPlayer() == Player::RED;
+            int e = (redToMove == (game % 2 == 0)) ? 0 : 1;
+            MinimaxResult result = engines[e].findBestMove(grid, limits);
+            nodes[e] += result.nodesEvaluated;
+            if (result.nodesPerSecond > 0.0) seconds[e] += result.nodesEvaluated / result.nodesPerSecond;
+            grid.makeMove(result.move.coord);
+        }
+        bool redWon = grid.getWinner() == Player::RED;
+        int winner = (redWon == (game % 2 == 0)) ? 0 : 1;
+        wins[winner]++;
+        if (!options.json) {
+            std::printf("game %3d: %s wins as %s\n", game + 1, names[winner], redWon ? "RED" : "BLUE");
+            std::fflush(stdout);
+        }
+    }
+
+    if (options.json) {
+        std::printf("[\n");
+        for (int e = 0; e < 2; e++) {
+            std::printf("  {\"evaluator\": \"%s\", \"games\": %d, \"wins\": %d, \"nodes_per_sec\": %.1f}%s\n",
+                        names[e], options.matchGames, wins[e], seconds[e] > 0 ? nodes[e] / seconds[e] : 0.0,
+                        e == 0 ? "," : "");
+        }
+        std::printf("]\n");
+    } else {
+        for (int e = 0; e < 2; e++) {
+            std::printf("%-14s %3d / %d wins %12.0f nodes/s\n", names[e], wins[e], options.matchGames,
+                        seconds[e] > 0 ? nodes[e] / seconds[e] : 0.0);
+        }
+    }
+}
+
+void printUsage() {
+    std::fprintf(stderr, "usage: bench [--json] [--min-time MS] [FILTER]\n"
+                         "       bench [--json] --match GAMES [--move-time MS]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            options.json = true;
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            options.minTimeMs = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--match") == 0 && i + 1 < argc) {
+            options.matchGames = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--move-time") == 0 && i + 1 < argc) {
+            options.moveTimeMs = std::max(1, std::atoi(argv[++i]));
+        } else if (argv[i][0] == '-') {
+            printUsage();
+            return 1;
+        } else {
+            options.filter = argv[i];
+        }
+    }
+
+    if (options.matchGames > 0) {
+        runMatch(options);
+        return 0;
+    }
+
+    Runner runner(options);
+    for (const Position& position : CORPUS) runPosition(runner, position);
+    if (options.json) runner.printJson();
+    return 0;
+}
@@ -0,0 +1,22 @@
+#!/bin/sh
+# Build and run the headless benchmark harness (no GUI, Linux/macOS).
+# Extra arguments are passed to the benchmark, e.g. ./bench.sh --json minimax
+set -e
+cd "$(dirname "$0")"
+mkdir -p build
+g++ -std=c++14 -O2 -Wall \
+    -o build/bench \
+    bench.cpp \
+    HexGrid.cpp \
+    PathFinding.cpp \
+    TranspositionTable.cpp \
+    ResistanceEvaluator.cpp \
+    VirtualConnections.cpp \
+    InferiorCells.cpp \
+    MoveScorer.cpp \
+    ThreatSearch.cpp \
+    EndgameSolver.cpp \
+    Minimax.cpp \
+    MonteCarlo.cpp \
+    -pthread
+./build/bench "$@"
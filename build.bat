@@ -13,10 +13,17 @@ g++ -std=c++14 -O2 -Wall ^
     main.cpp ^
     HexGrid.cpp ^
     PathFinding.cpp ^
+    TranspositionTable.cpp ^
+    ResistanceEvaluator.cpp ^
+    VirtualConnections.cpp ^
+    InferiorCells.cpp ^
+    MoveScorer.cpp ^
+    ThreatSearch.cpp ^
+    EndgameSolver.cpp ^
     Minimax.cpp ^
     MonteCarlo.cpp ^
     AI.cpp ^
-    -lgdi32 -luser32 -lkernel32 -mwindows
+    -pthread -lgdi32 -luser32 -lkernel32 -mwindows
 
 if %ERRORLEVEL% NEQ 0 (
     echo.
@@ -158,6 +158,7 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 NewGame(hwnd);
             } else if (wParam == 'Z' && (GetKeyState(VK_CONTROL) & 0x8000)) {  // Ctrl+Z for Undo
                 if (!g_grid->getMoveHistory().empty()) {
+                    g_ai->stopPondering();
                     g_grid->undoMove();
                     if (g_aiEnabled && !g_grid->getMoveHistory().empty()) {
                         g_grid->undoMove();
@@ -394,6 +395,7 @@ void ProcessMove(HWND hwnd, const HexCoord& coord) {
     // Check for winner after player's move
     Player winner = g_grid->getWinner();
     if (winner != Player::NONE) {
+        g_ai->stopPondering();
         g_gameOver = true;
         InvalidateRect(hwnd, NULL, FALSE);
         UpdateWindow(hwnd);
@@ -446,6 +448,9 @@ void MakeAIMove(HWND hwnd) {
                 
                 std::string msg = (winner == Player::RED) ? "RED WINS!" : "BLUE WINS!";
                 MessageBoxA(hwnd, msg.c_str(), "Game Over", MB_OK | MB_ICONINFORMATION);
+            } else {
+                // Keep searching on the player's time
+                g_ai->startPondering(*g_grid);
             }
         } else {
             g_aiThinking = false;
@@ -459,6 +464,7 @@ void MakeAIMove(HWND hwnd) {
 
 void NewGame(HWND hwnd) {
     g_grid->reset();
+    g_ai->newGame();
     g_gameOver = false;
     g_moveCount = 0;
     g_aiThinking = false;